@@ -0,0 +1,80 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "ScriptClassManifest.h"
+#include "SimpleScript.h"
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+
+const FPrimaryAssetType UScriptClassManifest::PrimaryAssetType(TEXT("ScriptClassManifest"));
+
+//============================================================================================================
+//
+//============================================================================================================
+FPrimaryAssetId UScriptClassManifest::GetPrimaryAssetId() const
+{
+	//Package name, asset names repeat between maps of the same name in different folders
+	return FPrimaryAssetId(PrimaryAssetType, GetPackage()->GetFName());
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptClassManifest::AddUse(const TSoftClassPtr<USimpleScript>& Class, int32 Count)
+{
+	if (Class.IsNull() || Count <= 0)
+		return;
+
+	for (FScriptClassManifestEntry &Entry : Entries)
+	{
+		if (Entry.Class == Class)
+		{
+			Entry.UseCount += Count;
+			return;
+		}
+	}
+
+	FScriptClassManifestEntry &Entry = Entries.AddDefaulted_GetRef();
+	Entry.Class = Class;
+	Entry.UseCount = Count;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptClassManifest::SortEntries()
+{
+	//Path as the tie breaker keeps the saved asset the same between runs
+	Entries.Sort([](const FScriptClassManifestEntry& A, const FScriptClassManifestEntry& B)
+	{
+		if (A.UseCount != B.UseCount)
+			return A.UseCount > B.UseCount;
+
+		return A.Class.ToString() < B.Class.ToString();
+	});
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+FString UScriptClassManifest::GetManifestPackageName(const FString& MapPackageName)
+{
+	return MapPackageName + TEXT("_ScriptManifest");
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+FSoftObjectPath UScriptClassManifest::GetManifestPath(const UWorld* World)
+{
+	if (!World)
+		return FSoftObjectPath();
+
+	const FString MapPackageName = UWorld::RemovePIEPrefix(World->GetPackage()->GetName());
+	if (!FPackageName::IsValidLongPackageName(MapPackageName))
+		return FSoftObjectPath();
+
+	const FString PackageName = GetManifestPackageName(MapPackageName);
+	return FSoftObjectPath(PackageName + TEXT(".") + FPackageName::GetShortName(PackageName));
+}
@@ -4,9 +4,15 @@
 
 #include "ScriptQueueComponent.h"
 #include "GameFramework/Actor.h"
-#include "Kismet/GameplayStatics.h"
+#include "Engine/Engine.h"
+#include "Engine/AssetManager.h"
+#include "TimerManager.h"
+#include "Async/Async.h"
 #include "GameFramework/Pawn.h"
 #include "SimpleScript.h"
+#include "ScriptQueueSubsystem.h"
+#include "ScriptClassManifest.h"
+#include "SimpleScriptWaitAction.h"
 
 
 //============================================================================================================
@@ -26,257 +32,2097 @@ UScriptQueueComponent::UScriptQueueComponent()
 //============================================================================================================
 class UScriptQueueComponent* UScriptQueueComponent::GetScriptQueueComponent(class UObject* WorldContext)
 {
-	class APlayerController *pController = UGameplayStatics::GetPlayerController(WorldContext, 0);
-	if (!IsValid(pController))
+	return GetScriptQueueComponentForPlayer(WorldContext, 0);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+class UScriptQueueComponent* UScriptQueueComponent::GetScriptQueueComponentForPlayer(class UObject* WorldContext, int32 PlayerIndex)
+{
+	class UWorld *pWorld = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull);
+	class UScriptQueueSubsystem *pSubsystem = pWorld ? pWorld->GetSubsystem<UScriptQueueSubsystem>() : NULL;
+	if (!pSubsystem)
+		return NULL;
+
+	return pSubsystem->FindQueueForPlayer(PlayerIndex);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+class UScriptQueueComponent* UScriptQueueComponent::GetScriptQueueComponentForActor(class AActor* Actor)
+{
+	class UWorld *pWorld = IsValid(Actor) ? Actor->GetWorld() : NULL;
+	class UScriptQueueSubsystem *pSubsystem = pWorld ? pWorld->GetSubsystem<UScriptQueueSubsystem>() : NULL;
+	if (!pSubsystem)
 		return NULL;
 
-	return pController->FindComponentByClass<UScriptQueueComponent>();
+	return pSubsystem->FindQueueForActor(Actor);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 UScriptQueueComponent::CancelScriptsOfClass(class UObject* WorldContext, TSubclassOf<USimpleScript> Class, bool IncludeSubclasses, bool IncludeActive)
+{
+	class UScriptQueueComponent *pComponent = GetScriptQueueComponent(WorldContext);
+	if (!IsValid(pComponent))
+		return 0;
+
+	return pComponent->CancelScriptsOfClass_Internal(Class, IncludeSubclasses, IncludeActive);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 UScriptQueueComponent::CancelScriptsOfClass_Internal(TSubclassOf<USimpleScript> Class, bool IncludeSubclasses, bool IncludeActive)
+{
+	if (!IsValid(Class))
+		return 0;
+
+	return CancelScripts([Class, IncludeSubclasses](const USimpleScript* Script) { return IsScriptOfClass(Script, Class, IncludeSubclasses); }, IncludeActive);
+}
+
+//============================================================================================================
+// A loading slot stands in for the script it is loading. The class it loads is not known until it has
+// loaded, so an unloaded slot only matches every script.
+//============================================================================================================
+bool UScriptQueueComponent::IsScriptOfClass(const USimpleScript* Script, const UClass* Class, bool IncludeSubclasses)
+{
+	const UClass *pClass = Script->GetClass();
+	if (const USimpleScriptLoadingSlot *pSlot = Cast<USimpleScriptLoadingSlot>(Script))
+	{
+		pClass = pSlot->ScriptClass.Get();
+		if (!pClass)
+			return IncludeSubclasses && Class == USimpleScript::StaticClass();
+	}
+
+	return IncludeSubclasses ? pClass->IsChildOf(Class) : pClass == Class;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 UScriptQueueComponent::CancelScriptsWithTag(class UObject* WorldContext, FGameplayTag Tag, bool IncludeActive)
+{
+	class UScriptQueueComponent *pComponent = GetScriptQueueComponent(WorldContext);
+	if (!IsValid(pComponent))
+		return 0;
+
+	return pComponent->CancelScriptsWithTag_Internal(Tag, IncludeActive);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 UScriptQueueComponent::CancelScriptsWithTag_Internal(FGameplayTag Tag, bool IncludeActive)
+{
+	if (!Tag.IsValid())
+		return 0;
+
+	return CancelScripts([&Tag](const USimpleScript* Script) { return Script->GetScriptTags().HasTag(Tag); }, IncludeActive);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 UScriptQueueComponent::CancelScripts(TFunctionRef<bool(const USimpleScript*)> Predicate, bool IncludeActive)
+{
+	TArray<class USimpleScript*> Cancelled;
+
+	//Destroyed scripts are dropped on the way
+	auto ShouldCancel = [&Predicate, IncludeActive](const USimpleScript* Script)
+	{
+		return !IsValid(Script) || ((IncludeActive || !Script->IsActive()) && Predicate(Script));
+	};
+
+	auto Collect = [this, &Cancelled, &ShouldCancel](class USimpleScript* Script)
+	{
+		if (!ShouldCancel(Script))
+			return false;
+
+		if (IsValid(Script))
+		{
+			Cancelled.Add(Script);
+		}
+		else
+		{
+			bLostScripts = true;
+		}
+
+		return true;
+	};
+
+	Queue.RemoveAll(Collect);
+	InstantScripts.RemoveAll(Collect);
+	WaitingScripts.RemoveAll(Collect);
+
+	//Pending instant scripts are also in InstantScripts, so they are already collected
+	PendingInstantScripts.RemoveAll(ShouldCancel);
+	UrgentInstantScripts.RemoveAll(ShouldCancel);
+
+	for (TPair<FGameplayTag, FScriptQueueLane> &Pair : Lanes)
+	{
+		FScriptQueueLane &Lane = Pair.Value;
+
+		if (Lane.Active && Collect(Lane.Active))
+		{
+			Lane.Active = NULL;
+			LaneScriptCount--;
+		}
+
+		const int32 iRemoved = Lane.Pending.RemoveAll([&Collect](const FScriptLaneEntry& Entry) { return Collect(Entry.Script); });
+		if (iRemoved > 0)
+		{
+			LaneScriptCount -= iRemoved;
+			Lane.Pending.Heapify(FScriptLaneEntry());
+		}
+
+		bLanesIdle |= !Lane.Active && Lane.Pending.Num() > 0;
+	}
+
+	for (TArray<FScriptTimerEntry> *pTimers : { &GameTimers, &RealTimers })
+	{
+		if (pTimers->RemoveAll([&Collect](const FScriptTimerEntry& Entry) { return Collect(Entry.Script); }) > 0)
+		{
+			pTimers->Heapify(FScriptTimerEntry());
+		}
+	}
+
+	//Everything is out of the queues before any callbacks run
+	for (class USimpleScript *pScript : Cancelled)
+	{
+		if (pScript->IsA<USimpleScriptLoadingSlot>())
+		{
+			LoadingSlotCount--;
+		}
+		else
+		{
+			UpdateOccupancy(pScript->GetScriptClassId(), -1);
+		}
+
+		Preloads.Remove(pScript);
+
+		ReleaseDependents(pScript);
+
+		pScript->Cancel();
+
+		if (!bBatchCancelEvents)
+		{
+			OnScriptCancelled.Broadcast(pScript);
+		}
+	}
+
+	if (bBatchCancelEvents && Cancelled.Num() > 0)
+	{
+		OnScriptsCancelled.Broadcast(Cancelled);
+	}
+
+	for (class USimpleScript *pScript : Cancelled)
+	{
+		ReleaseFinishedToPool(pScript);
+	}
+
+	//Scripts further back moved into the lookahead window
+	UpdatePreloads();
+
+	if (Cancelled.Num() > 0 && !HasQueue())
+	{
+		OnQueueFinished.Broadcast();
+	}
+
+	RefreshTick();
+
+	return Cancelled.Num();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	ProcessQueue(DeltaTime);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::ProcessQueue(float DeltaTime)
+{
+	if (bPrewarming)
+	{
+		TickPrewarm();
+	}
+
+	if (!Inbox.IsEmpty())
+	{
+		DrainInbox();
+	}
+
+	//Due scripts are activated in the same tick, subject to the activation budget
+	if (GameTimers.Num() > 0 || RealTimers.Num() > 0)
+	{
+		ProcessTimers();
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	int32 iActivations = 0;
+
+	//Urgent scripts skip the activation budget. Activate can cancel scripts, so the rings are checked on every pass.
+	bool bFoundInvalid = false;
+	for (int32 i=UrgentInstantScripts.Num(); i>0 && UrgentInstantScripts.Num() > 0; i--)
+	{
+		class USimpleScript *pScript = UrgentInstantScripts.PopFront();
+		if (IsValid(pScript))
+		{
+			pScript->Activate();
+		}
+		else
+		{
+			bFoundInvalid = true;
+		}
+	}
+
+	if (bLanesIdle)
+	{
+		ActivateLanes(StartCycles, iActivations);
+	}
+
+	if (Queue.Num() > 0)
+	{
+		UpdatePreloads();
+
+		class USimpleScript *pHead = Queue.First();
+		if (!IsValid(pHead))
+		{
+			Queue.PopFront();
+			bLostScripts = true;
+		}
+		else if (!pHead->IsActive() && (pHead->GetIsUrgent() || HasActivationBudget(StartCycles, iActivations)) && CanActivateHead(pHead))
+		{
+			pHead->Activate();
+			iActivations++;
+		}
+	}
+
+	//Only the instant scripts added since the last tick need activating.
+	//Scripts added while activating go to the back and wait for the next tick,
+	//scripts over the budget stay at the front for the next tick.
+	for (int32 i=PendingInstantScripts.Num(); i>0 && PendingInstantScripts.Num() > 0 && HasActivationBudget(StartCycles, iActivations); i--)
+	{
+		class USimpleScript *pScript = PendingInstantScripts.PopFront();
+		if (IsValid(pScript))
+		{
+			pScript->Activate();
+			iActivations++;
+		}
+		else
+		{
+			bFoundInvalid = true;
+		}
+	}
+
+	if (bFoundInvalid)
+	{
+		CompactInstantScripts();
+	}
+
+	RefreshTick();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool UScriptQueueComponent::HasActivationBudget(uint64 StartCycles, int32 Activations) const
+{
+	switch (ActivationBudget)
+	{
+	case EScriptActivationBudget::Count:
+		return Activations < MaxActivationsPerFrame;
+
+	case EScriptActivationBudget::Time:
+		//Always let one through so the queue keeps moving even with scripts slower than the budget
+		return Activations == 0 || FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0 < ActivationBudgetMicroseconds;
+
+	default:
+		return true;
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::ActivateLanes(uint64 StartCycles, int32& Activations)
+{
+	bLanesIdle = false;
+
+	//Activate runs user code that can add scripts to new lanes, so the map is not iterated while activating
+	TArray<class USimpleScript*, TInlineAllocator<8>> Activating;
+
+	for (TPair<FGameplayTag, FScriptQueueLane> &Pair : Lanes)
+	{
+		FScriptQueueLane &Lane = Pair.Value;
+		if (Lane.Active || Lane.Pending.Num() == 0)
+			continue;
+
+		FScriptLaneEntry Entry;
+		Lane.Pending.HeapPop(Entry, FScriptLaneEntry(), EAllowShrinking::No);
+
+		if (!IsValid(Entry.Script))
+		{
+			LaneScriptCount--;
+			bLostScripts = true;
+			bLanesIdle |= Lane.Pending.Num() > 0;
+			continue;
+		}
+
+		if (!Entry.Script->GetIsUrgent() && !HasActivationBudget(StartCycles, Activations))
+		{
+			//Put it back for the next tick
+			Lane.Pending.HeapPush(Entry, FScriptLaneEntry());
+			bLanesIdle = true;
+			continue;
+		}
+
+		Lane.Active = Entry.Script;
+		Activating.Add(Entry.Script);
+		Activations++;
+	}
+
+	for (class USimpleScript *pScript : Activating)
+	{
+		//An earlier script can have cancelled it
+		const FScriptQueueLane *pLane = Lanes.Find(pScript->QueuedLane);
+		if (pLane && pLane->Active == pScript && IsValid(pScript))
+		{
+			pScript->Activate();
+		}
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+class USimpleScript* UScriptQueueComponent::GetLaneScript(FGameplayTag Lane) const
+{
+	const FScriptQueueLane *pLane = Lanes.Find(Lane);
+	return pLane ? pLane->Active : NULL;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool UScriptQueueComponent::NeedsTick() const
+{
+	if (bPrewarming || bLanesIdle || PendingInstantScripts.Num() > 0 || UrgentInstantScripts.Num() > 0 || !Inbox.IsEmpty())
+		return true;
+
+	//Timers that are not due yet have a wake up armed instead
+	if (IsTimerDue())
+		return true;
+
+	//A running head only needs FinishScript, which re-arms the tick. A head waiting for its class or assets is woken by the load.
+	if (Queue.Num() == 0)
+		return false;
+
+	const class USimpleScript *pHead = Queue.First();
+	return !IsValid(pHead) || (!pHead->IsActive() && !pHead->IsA<USimpleScriptLoadingSlot>() && !IsWaitingForPreload(pHead));
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::RefreshTick()
+{
+	//Runs after every queue change, so the counts are right again before anything else reads them
+	if (bLostScripts)
+	{
+		RebuildOccupancy();
+	}
+
+	if (bTicklessWithQueue)
+	{
+		TicksAvoided += (int32)(GFrameCounter - TicklessSinceFrame);
+		bTicklessWithQueue = false;
+	}
+
+	const bool bTick = IsActive() && NeedsTick();
+
+	if (SubsystemIndex != INDEX_NONE)
+	{
+		QueueSubsystem->SetComponentAwake(this, bTick);
+	}
+	else
+	{
+		PrimaryComponentTick.SetTickFunctionEnable(bTick);
+	}
+
+	UpdateTimerWakes(!bTick && IsActive());
+	UpdateRunningCheck(!bTick && IsActive());
+
+	//Count the frames that would have ticked only to find the head still running
+	if (!bTick && IsActive() && HasQueue())
+	{
+		bTicklessWithQueue = true;
+		TicklessSinceFrame = GFrameCounter;
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool UScriptQueueComponent::CompactInstantScripts()
+{
+	const int32 OldNum = InstantScripts.Num();
+
+	for (int32 i=InstantScripts.Num()-1; i>=0; i--)
+	{
+		if (!IsValid(InstantScripts.GetData()[i]))
+		{
+			InstantScripts.RemoveAtSwap(i, 1, EAllowShrinking::No);
+		}
+	}
+
+	if (InstantScripts.Num() == OldNum)
+		return false;
+
+	bLostScripts = true;
+	return true;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterFromSubsystem();
+
+	UpdateTimerWakes(false);
+	UpdateRunningCheck(false);
+
+	Preloads.Reset();
+
+	if (ManifestHandle.IsValid())
+	{
+		ManifestHandle->CancelHandle();
+		ManifestHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::RegisterWithSubsystem()
+{
+	if (QueueSubsystem)
+		return;
+
+	class UWorld *pWorld = GetWorld();
+	QueueSubsystem = pWorld ? pWorld->GetSubsystem<UScriptQueueSubsystem>() : NULL;
+
+	if (QueueSubsystem)
+	{
+		QueueSubsystem->RegisterComponent(this, TickMode == EScriptQueueTickMode::Subsystem);
+
+		if (SubsystemIndex != INDEX_NONE)
+		{
+			PrimaryComponentTick.SetTickFunctionEnable(false);
+		}
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::UnregisterFromSubsystem()
+{
+	if (QueueSubsystem)
+	{
+		QueueSubsystem->UnregisterComponent(this);
+		QueueSubsystem = NULL;
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool UScriptQueueComponent::HasScriptInQueue(TSubclassOf<USimpleScript> Class, bool IncludeSubclasses) const
+{
+	const int32 ClassId = FSimpleScriptClassRegistry::GetId(Class);
+	const TArray<int32> &Table = IncludeSubclasses ? SubclassOccupancy : Occupancy;
+	if (Table.IsValidIndex(ClassId) && Table.GetData()[ClassId] > 0)
+		return true;
+
+	//Loading slots are not in the tables, they only wait in Queue
+	if (LoadingSlotCount > 0 && ClassId != INDEX_NONE)
+	{
+		for (int32 i=0; i<Queue.Num(); i++)
+		{
+			const USimpleScript *pScript = Queue[i];
+			if (IsValid(pScript) && pScript->IsA<USimpleScriptLoadingSlot>() && IsScriptOfClass(pScript, Class, IncludeSubclasses))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::UpdateOccupancy(int32 ClassId, int32 Delta)
+{
+	GrowClassTables(ClassId);
+
+	Occupancy.GetData()[ClassId] += Delta;
+
+	for (const int32 AncestorId : GetClassCache(ClassId).Ancestors)
+	{
+		SubclassOccupancy.GetData()[AncestorId] += Delta;
+	}
+}
+
+//============================================================================================================
+// The garbage collector clears the references to destroyed scripts, so their class ids can't be read back
+// when they are dropped. The scripts still in the queues are counted instead.
+//============================================================================================================
+void UScriptQueueComponent::RebuildOccupancy()
+{
+	bLostScripts = false;
+	LoadingSlotCount = 0;
+
+	GrowClassTables();
+	FMemory::Memzero(Occupancy.GetData(), Occupancy.Num() * sizeof(int32));
+	FMemory::Memzero(SubclassOccupancy.GetData(), SubclassOccupancy.Num() * sizeof(int32));
+
+	auto Count = [this](const USimpleScript* Script)
+	{
+		if (!IsValid(Script))
+			return;
+
+		if (Script->IsA<USimpleScriptLoadingSlot>())
+		{
+			LoadingSlotCount++;
+		}
+		else
+		{
+			UpdateOccupancy(Script->GetScriptClassId(), 1);
+		}
+	};
+
+	for (int32 i=0; i<Queue.Num(); i++)
+	{
+		Count(Queue[i]);
+	}
+
+	//Pending instant scripts are also in InstantScripts
+	for (const USimpleScript *pScript : InstantScripts)
+	{
+		Count(pScript);
+	}
+
+	for (const USimpleScript *pScript : WaitingScripts)
+	{
+		Count(pScript);
+	}
+
+	for (const TPair<FGameplayTag, FScriptQueueLane> &Pair : Lanes)
+	{
+		Count(Pair.Value.Active);
+
+		for (const FScriptLaneEntry &Entry : Pair.Value.Pending)
+		{
+			Count(Entry.Script);
+		}
+	}
+
+	for (const FScriptTimerEntry &Entry : GameTimers)
+	{
+		Count(Entry.Script);
+	}
+
+	for (const FScriptTimerEntry &Entry : RealTimers)
+	{
+		Count(Entry.Script);
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::GrowClassTables()
+{
+	const int32 Num = FSimpleScriptClassRegistry::Num();
+	RepeatCounts.SetNumZeroed(Num);
+	Occupancy.SetNumZeroed(Num);
+	SubclassOccupancy.SetNumZeroed(Num);
+	ScriptPool.SetNum(Num);
+	ClassCache.SetNum(Num);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+const FScriptQueueClassCache& UScriptQueueComponent::CacheClass(int32 ClassId)
+{
+	FScriptQueueClassCache &Cache = ClassCache.GetData()[ClassId];
+	Cache.Ancestors = FSimpleScriptClassRegistry::GetAncestors(ClassId);
+	Cache.bUseScriptPool = FSimpleScriptClassRegistry::GetDefaults(ClassId).bUseScriptPool;
+	Cache.bCached = true;
+	return Cache;
+}
+
+//============================================================================================================
+// A recompiled class can have a new parent or new defaults
+//============================================================================================================
+void UScriptQueueComponent::ResetClassCache()
+{
+	ClassCacheGeneration = FSimpleScriptClassRegistry::GetGeneration();
+	for (FScriptQueueClassCache &Cache : ClassCache)
+	{
+		Cache.bCached = false;
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::Serialize(FArchive& Ar)
+{
+	if (Ar.IsSaving())
+	{
+		RepeatCountsToCounts();
+	}
+
+	Super::Serialize(Ar);
+
+	if (Ar.IsLoading())
+	{
+		CountsToRepeatCounts();
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::CountsToRepeatCounts()
+{
+	RepeatCounts.Reset();
+
+	for (const TPair<TSubclassOf<USimpleScript>, int32> &Pair : Counts)
+	{
+		const int32 ClassId = FSimpleScriptClassRegistry::GetId(Pair.Key);
+		if (ClassId != INDEX_NONE)
+		{
+			GrowClassTables(ClassId);
+			RepeatCounts.GetData()[ClassId] = Pair.Value;
+		}
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::RepeatCountsToCounts()
+{
+	for (int32 ClassId=0; ClassId<RepeatCounts.Num(); ClassId++)
+	{
+		UClass *pClass = FSimpleScriptClassRegistry::GetClass(ClassId);
+		if (pClass && RepeatCounts.GetData()[ClassId] > 0)
+		{
+			Counts.Emplace(pClass, RepeatCounts.GetData()[ClassId]);
+		}
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::FinishScript(class USimpleScript *Script, bool Success)
+{
+	if (!IsValid(Script))
+	{
+		return;
+	}
+
+	const int32 ClassId = Script->GetScriptClassId();
+	UpdateOccupancy(ClassId, -1);
+
+	//Increase repeat counts
+	RepeatCounts.GetData()[ClassId]++;
+
+	ReleaseDependents(Script);
+
+	bool bWasHead = false;
+	FScriptQueueLane *pLane = Script->QueuedLane.IsValid() ? Lanes.Find(Script->QueuedLane) : NULL;
+	if (pLane && pLane->Active == Script)
+	{
+		pLane->Active = NULL;
+		LaneScriptCount--;
+		bLanesIdle |= pLane->Pending.Num() > 0;
+		Script->QueuedLane = FGameplayTag();
+	}
+	else if (Queue.Num() > 0 && Queue.First() == Script)
+	{
+		Queue.PopFront();
+		bWasHead = true;
+	}
+	else
+	{
+		InstantScripts.RemoveSingleSwap(Script, EAllowShrinking::No);
+	}
+
+	ReleaseFinishedToPool(Script);
+
+	if (Preloads.Num() > 0)
+	{
+		Preloads.Remove(Script);
+	}
+
+	if (!HasQueue())
+	{
+		OnQueueFinished.Broadcast();
+	}
+	else if (bWasHead)
+	{
+		UpdatePreloads();
+		ChainActivateQueueHead();
+	}
+
+	RefreshTick();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool UScriptQueueComponent::ChainActivateQueueHead()
+{
+	//Scripts that finish inside OnActivate would keep recursing through here, let the tick continue instead
+	if (!bChainQueue || !IsActive() || ChainDepth >= MaxChainDepth)
+		return false;
+
+	if (ChainFrame != GFrameCounter)
+	{
+		ChainFrame = GFrameCounter;
+		ChainedActivations = 0;
+	}
+
+	if (MaxChainedActivationsPerFrame >= 0 && ChainedActivations >= MaxChainedActivationsPerFrame)
+		return false;
+
+	while (Queue.Num() > 0 && !IsValid(Queue.First()))
+	{
+		Queue.PopFront();
+		bLostScripts = true;
+	}
+
+	if (Queue.Num() == 0 || Queue.First()->IsActive() || !CanActivateHead(Queue.First()))
+		return false;
+
+	ChainedActivations++;
+	ChainDepth++;
+	Queue.First()->Activate();
+	ChainDepth--;
+
+	return true;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::UpdatePreloads()
+{
+	if (PreloadLookahead <= 0)
+		return;
+
+	//Scripts that were destroyed while waiting never finish
+	if (Preloads.Num() > PreloadLookahead * 2)
+	{
+		for (auto It = Preloads.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	const int32 iNum = FMath::Min(PreloadLookahead, Queue.Num());
+	for (int32 i=0; i<iNum; i++)
+	{
+		class USimpleScript *pScript = Queue[i];
+		if (!IsValid(pScript) || Preloads.Contains(pScript))
+			continue;
+
+		TArray<FSoftObjectPath> Assets;
+		pScript->GetPreloadAssets(Assets);
+
+		FScriptPreload &Preload = Preloads.Add(pScript);
+		if (Assets.Num() > 0)
+		{
+			//Wakes up a head that is waiting for the assets
+			Preload.Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(Assets), FStreamableDelegate::CreateUObject(this, &UScriptQueueComponent::RefreshTick));
+		}
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool UScriptQueueComponent::CheckPreload(class USimpleScript* Head)
+{
+	FScriptPreload *pPreload = Preloads.Find(Head);
+	if (!pPreload || !pPreload->Handle.IsValid())
+		return true;
+
+	const bool bLoaded = pPreload->Handle->HasLoadCompleted() || pPreload->Handle->WasCanceled();
+
+	if (!pPreload->bCounted)
+	{
+		pPreload->bCounted = true;
+		if (bLoaded)
+		{
+			PreloadHits++;
+		}
+		else
+		{
+			PreloadStalls++;
+		}
+	}
+
+	return bLoaded || !bWaitForPreloadedAssets;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool UScriptQueueComponent::IsWaitingForPreload(const class USimpleScript* Script) const
+{
+	if (!bWaitForPreloadedAssets)
+		return false;
+
+	const FScriptPreload *pPreload = Preloads.Find(Script);
+	return pPreload && pPreload->Handle.IsValid() && !pPreload->Handle->HasLoadCompleted() && !pPreload->Handle->WasCanceled();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+class USimpleScript* UScriptQueueComponent::Node_CreateScript(class UObject* WorldContext, TSubclassOf<USimpleScript> Class, int32 RepeatCount)
+{
+	if (!IsValid(Class))
+	{
+		return NULL;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("%s input count %d"), *Class->GetName(), RepeatCount);
+
+	class UScriptQueueComponent *pComponent = GetScriptQueueComponent(WorldContext);
+	if (!IsValid(pComponent))
+	{
+		return NULL;
+	}
+
+	return pComponent->CreateScript(WorldContext, Class, RepeatCount);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+class USimpleScript* UScriptQueueComponent::CreateScript(class UObject* Outer, TSubclassOf<USimpleScript> Class, int32 RepeatCount)
+{
+	if (!IsValid(Class))
+	{
+		return NULL;
+	}
+
+	const int32 ClassId = FSimpleScriptClassRegistry::GetId(Class);
+	if (RepeatCount > 0 && GetRepeatCountById(ClassId))
+	{
+		return NULL;
+	}
+
+	//Use one from pool if we have it
+	const bool bPooled = GetClassCache(ClassId).bUseScriptPool;
+	class USimpleScript *pScript = bPooled ? AcquirePooledScript(ClassId) : NULL;
+	if (!pScript)
+	{
+		pScript = NewObject<USimpleScript>((Outer && !bPooled) ? Outer : this, Class);
+		ColdCreations++;
+		ColdCreationsAfterPrewarm += bPrewarming ? 0 : 1;
+	}
+
+	CreatedScripts.Add(pScript);
+	pScript->Initialize(this);
+	return pScript;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::CreateScripts(class UObject* Outer, TSubclassOf<USimpleScript> Class, int32 Count, TArray<class USimpleScript*>& OutScripts, int32 RepeatCount)
+{
+	if (!IsValid(Class) || Count <= 0)
+		return;
+
+	const int32 ClassId = FSimpleScriptClassRegistry::GetId(Class);
+	if (RepeatCount > 0 && GetRepeatCountById(ClassId))
+		return;
+
+	const int32 iFirst = OutScripts.Num();
+	OutScripts.Reserve(iFirst + Count);
+
+	const bool bPooled = GetClassCache(ClassId).bUseScriptPool;
+
+	int32 iPooled = 0;
+	if (bPooled)
+	{
+		iPooled = AcquirePooledScripts(ClassId, Count, OutScripts);
+	}
+
+	//Pooled scripts are handed out again later, they belong to the component like the prewarmed ones
+	class UObject *pOuter = (Outer && !bPooled) ? Outer : this;
+	for (int32 i=iPooled; i<Count; i++)
+	{
+		OutScripts.Add(NewObject<USimpleScript>(pOuter, Class));
+	}
+
+	ColdCreations += Count - iPooled;
+	ColdCreationsAfterPrewarm += bPrewarming ? 0 : Count - iPooled;
+
+	CreatedScripts.Reserve(CreatedScripts.Num() + Count);
+	for (int32 i=iFirst; i<OutScripts.Num(); i++)
+	{
+		class USimpleScript *pScript = OutScripts.GetData()[i];
+		CreatedScripts.Add(pScript);
+		pScript->Initialize(this);
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 UScriptQueueComponent::GetPooledScriptCountOfClass(TSubclassOf<USimpleScript> Class) const
+{
+	const int32 ClassId = FSimpleScriptClassRegistry::GetId(Class);
+	return ScriptPool.IsValidIndex(ClassId) ? ScriptPool.GetData()[ClassId].Scripts.Num() : 0;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+TArray<class USimpleScript*> UScriptQueueComponent::GetPooledScripts() const
+{
+	TArray<class USimpleScript*> Scripts;
+	Scripts.Reserve(PooledScriptCount);
+	for (const FScriptPoolBucket &Bucket : ScriptPool)
+	{
+		Scripts.Append(Bucket.Scripts);
+	}
+	return Scripts;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+class USimpleScript* UScriptQueueComponent::AcquirePooledScript(int32 ClassId)
+{
+	if (!ScriptPool.IsValidIndex(ClassId))
+		return NULL;
+
+	FScriptPoolBucket *pBucket = &ScriptPool.GetData()[ClassId];
+	while (pBucket->Scripts.Num() > 0)
+	{
+		class USimpleScript *pScript = pBucket->Scripts.Pop(EAllowShrinking::No);
+		PooledScriptCount--;
+
+		if (IsValid(pScript))
+		{
+			if (pBucket->Scripts.Num() > 0)
+			{
+				TouchPoolBucket(ClassId);
+			}
+			else
+			{
+				UnlinkPoolBucket(ClassId);
+			}
+			return pScript;
+		}
+	}
+
+	UnlinkPoolBucket(ClassId);
+	return NULL;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 UScriptQueueComponent::AcquirePooledScripts(int32 ClassId, int32 Count, TArray<class USimpleScript*>& OutScripts)
+{
+	if (!ScriptPool.IsValidIndex(ClassId) || Count <= 0)
+		return 0;
+
+	FScriptPoolBucket &Bucket = ScriptPool.GetData()[ClassId];
+
+	//Take a block from the back of the bucket, destroyed scripts are dropped on the way
+	const int32 iTake = FMath::Min(Count, Bucket.Scripts.Num());
+	const int32 iStart = Bucket.Scripts.Num() - iTake;
+
+	int32 iAcquired = 0;
+	for (int32 i=Bucket.Scripts.Num()-1; i>=iStart; i--)
+	{
+		class USimpleScript *pScript = Bucket.Scripts.GetData()[i];
+		if (IsValid(pScript))
+		{
+			OutScripts.Add(pScript);
+			iAcquired++;
+		}
+	}
+
+	Bucket.Scripts.SetNum(iStart, EAllowShrinking::No);
+	PooledScriptCount -= iTake;
+
+	if (Bucket.Scripts.Num() == 0)
+	{
+		UnlinkPoolBucket(ClassId);
+	}
+	else if (iAcquired > 0)
+	{
+		TouchPoolBucket(ClassId);
+	}
+
+	return iAcquired;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool UScriptQueueComponent::ReleaseToPool(class USimpleScript* Script, bool bReset)
+{
+	if (PoolSize == 0 || !Script->GetUsePool())
+		return false;
+
+	FScriptPoolBucket &Bucket = GetPoolBucket(Script->GetScriptClassId());
+
+	//Class is full, the scripts are identical so just let this one go
+	if (Bucket.MaxSize >= 0 && Bucket.Scripts.Num() >= Bucket.MaxSize)
+		return false;
+
+	if (bReset)
+	{
+		Script->OnReturnedToPool();
+
+		if (bResetPooledScripts)
+		{
+			if (!Bucket.ResetSnapshot.IsValid())
+			{
+				Bucket.ResetSnapshot = MakeShared<FSimpleScriptResetSnapshot>();
+				Bucket.ResetSnapshot->Capture(Script->GetClass());
+			}
+
+			Bucket.ResetSnapshot->Apply(Script);
+		}
+	}
+
+	if (PoolSize > 0 && PooledScriptCount >= PoolSize)
+	{
+		EvictFromPool();
+	}
+
+	Bucket.Scripts.Add(Script);
+	TouchPoolBucket(Script->GetScriptClassId());
+	PooledScriptCount++;
+	return true;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::ReleaseFinishedToPool(class USimpleScript* Script)
+{
+	//The node resumes on a later latent update with the script on its pins, it must not be reset or reused before that
+	if (Script->bWaitResultPending)
+	{
+		Script->bPoolAfterWaitResult = true;
+		return;
+	}
+
+	ReleaseToPool(Script);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::ReleaseToPoolNextTick(class USimpleScript* Script)
+{
+	class UWorld *pWorld = GetWorld();
+	if (!pWorld)
+		return;
+
+	//Skipped if the script was created again in the meantime
+	const TWeakObjectPtr<USimpleScript> WeakScript(Script);
+	const uint32 Serial = Script->Serial;
+
+	pWorld->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this, WeakScript, Serial]()
+	{
+		class USimpleScript *pScript = WeakScript.Get();
+		if (pScript && pScript->Serial == Serial && !pScript->IsActive())
+		{
+			ReleaseToPool(pScript);
+		}
+	}));
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+FScriptPoolBucket& UScriptQueueComponent::GetPoolBucket(int32 ClassId)
+{
+	GrowClassTables(ClassId);
+
+	FScriptPoolBucket &Bucket = ScriptPool.GetData()[ClassId];
+	if (!Bucket.bInitialized)
+	{
+		Bucket.Class = FSimpleScriptClassRegistry::GetClass(ClassId);
+
+		const int32 *pClassSize = PoolSizePerClass.Find(Bucket.Class);
+		Bucket.MaxSize = pClassSize ? *pClassSize : -1;
+		Bucket.bInitialized = true;
+	}
+
+	return Bucket;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::EvictFromPool()
+{
+	const int32 ClassId = OldestPoolClassId;
+	if (ClassId == INDEX_NONE)
+		return;
+
+	//Scripts of one class are interchangeable, so the one at the back goes
+	FScriptPoolBucket &Bucket = ScriptPool.GetData()[ClassId];
+	Bucket.Scripts.Pop(EAllowShrinking::No);
+	PooledScriptCount--;
+
+	if (Bucket.Scripts.Num() == 0)
+	{
+		UnlinkPoolBucket(ClassId);
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::TouchPoolBucket(int32 ClassId)
+{
+	if (NewestPoolClassId == ClassId)
+		return;
+
+	UnlinkPoolBucket(ClassId);
+
+	FScriptPoolBucket &Bucket = ScriptPool.GetData()[ClassId];
+	Bucket.OlderClassId = NewestPoolClassId;
+
+	if (NewestPoolClassId != INDEX_NONE)
+	{
+		ScriptPool.GetData()[NewestPoolClassId].NewerClassId = ClassId;
+	}
+	else
+	{
+		OldestPoolClassId = ClassId;
+	}
+
+	NewestPoolClassId = ClassId;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::UnlinkPoolBucket(int32 ClassId)
+{
+	FScriptPoolBucket &Bucket = ScriptPool.GetData()[ClassId];
+
+	//Not in the list
+	if (Bucket.NewerClassId == INDEX_NONE && NewestPoolClassId != ClassId)
+		return;
+
+	if (Bucket.NewerClassId != INDEX_NONE)
+	{
+		ScriptPool.GetData()[Bucket.NewerClassId].OlderClassId = Bucket.OlderClassId;
+	}
+	else
+	{
+		NewestPoolClassId = Bucket.OlderClassId;
+	}
+
+	if (Bucket.OlderClassId != INDEX_NONE)
+	{
+		ScriptPool.GetData()[Bucket.OlderClassId].NewerClassId = Bucket.NewerClassId;
+	}
+	else
+	{
+		OldestPoolClassId = Bucket.NewerClassId;
+	}
+
+	Bucket.NewerClassId = INDEX_NONE;
+	Bucket.OlderClassId = INDEX_NONE;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::TickPrewarm()
+{
+	const double EndTime = FPlatformTime::Seconds() + PrewarmBudgetMs * 0.001;
+
+	while (PrewarmIndex < PrewarmScripts.Num())
+	{
+		//Pool is full, more scripts would only evict the ones we just made
+		if (PoolSize == 0 || (PoolSize > 0 && PooledScriptCount >= PoolSize))
+			break;
+
+		const FScriptPoolPrewarm &Entry = PrewarmScripts.GetData()[PrewarmIndex];
+		const int32 ClassId = FSimpleScriptClassRegistry::GetId(Entry.Class);
+		if (ClassId == INDEX_NONE || !GetClassCache(ClassId).bUseScriptPool || PrewarmCreated >= Entry.Count)
+		{
+			PrewarmIndex++;
+			PrewarmCreated = 0;
+			continue;
+		}
+
+		if (!ReleaseToPool(NewObject<USimpleScript>(this, Entry.Class), false))
+		{
+			//Class limit reached
+			PrewarmIndex++;
+			PrewarmCreated = 0;
+			continue;
+		}
+
+		PrewarmCreated++;
+
+		if (FPlatformTime::Seconds() >= EndTime)
+			return;
+	}
+
+	bPrewarming = false;
+	bPrewarmDone = true;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::Activate(bool bReset)
+{
+	Super::Activate();
+
+	RegisterWithSubsystem();
+
+	if (bUseClassManifest && !bManifestRequested)
+	{
+		RequestClassManifest();
+	}
+
+	if (!bPrewarmDone && PrewarmScripts.Num() > 0)
+	{
+		bPrewarming = true;
+	}
+
+	RefreshTick();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::RequestClassManifest()
+{
+	bManifestRequested = true;
+
+	FSoftObjectPath Path = ClassManifest.ToSoftObjectPath();
+	if (Path.IsNull())
+	{
+		//Maps without Create Script nodes have no manifest, don't log a failed load for them.
+		//The asset manager scanned the manifests at startup, so this doesn't touch the disk.
+		Path = UScriptClassManifest::GetManifestPath(GetWorld());
+		const UAssetManager *pAssetManager = UAssetManager::GetIfInitialized();
+		if (Path.IsNull() || !pAssetManager || !pAssetManager->GetPrimaryAssetPath(FPrimaryAssetId(UScriptClassManifest::PrimaryAssetType, Path.GetLongPackageFName())).IsValid())
+			return;
+	}
+
+	ManifestHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Path, FStreamableDelegate::CreateUObject(this, &UScriptQueueComponent::OnClassManifestLoaded, Path));
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::OnClassManifestLoaded(FSoftObjectPath Path)
+{
+	//Not from the handle, an already loaded manifest calls this before the handle is returned
+	const class UScriptClassManifest *pManifest = Cast<UScriptClassManifest>(Path.ResolveObject());
+	if (!pManifest)
+		return;
+
+	TArray<FSoftObjectPath> ClassPaths;
+	ClassPaths.Reserve(pManifest->Entries.Num());
+	for (const FScriptClassManifestEntry &Entry : pManifest->Entries)
+	{
+		if (!Entry.Class.IsNull())
+		{
+			ClassPaths.Add(Entry.Class.ToSoftObjectPath());
+		}
+	}
+
+	if (ClassPaths.Num() == 0)
+		return;
+
+	//Entries are copied, the manifest itself is not needed after this
+	ManifestHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(ClassPaths, FStreamableDelegate::CreateUObject(this, &UScriptQueueComponent::OnManifestClassesLoaded, pManifest->Entries));
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::OnManifestClassesLoaded(TArray<FScriptClassManifestEntry> Entries)
+{
+	bool bAdded = false;
+	for (const FScriptClassManifestEntry &Entry : Entries)
+	{
+		class UClass *pClass = Entry.Class.Get();
+		const int32 Count = FMath::Min(Entry.UseCount, ManifestPrewarmLimit);
+		if (!pClass || Count <= 0)
+			continue;
+
+		//Hand written entries win
+		if (PrewarmScripts.ContainsByPredicate([pClass](const FScriptPoolPrewarm& Prewarm) { return Prewarm.Class == pClass; }))
+			continue;
+
+		FScriptPoolPrewarm &Prewarm = PrewarmScripts.AddDefaulted_GetRef();
+		Prewarm.Class = pClass;
+		Prewarm.Count = Count;
+
+		bAdded = true;
+	}
+
+	if (!bAdded)
+		return;
+
+	//Continues from the entry where the earlier prewarm stopped
+	bPrewarmDone = false;
+	bPrewarming = IsActive();
+
+	RefreshTick();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::Deactivate()
+{
+	Super::Deactivate();
+
+	//Stays registered so the queue can still be found, it only falls asleep
+	RefreshTick();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::AddScriptToQueue(class USimpleScript* Script)
+{
+	if (!IsValid(Script))
+		return;
+
+	if (Script->GetStartDelay() > 0.0f && GetWorld())
+	{
+		AddScriptToQueueAt(Script, Script->GetStartDelay(), Script->GetStartDelayRealTime());
+		return;
+	}
+
+	AddScriptToQueueNow(Script);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::AddScriptToQueueNow(class USimpleScript* Script)
+{
+	UpdateOccupancy(Script->GetScriptClassId(), 1);
+
+	const bool bSerial = InsertScript(Script);
+	if (bSerial && Queue.Num() <= PreloadLookahead)
+	{
+		UpdatePreloads();
+	}
+
+	OnScriptAdded.Broadcast(Script);
+
+	Script->OnAddedToQueue();
+
+	//Idle queue, no need to wait for the next tick
+	if (bSerial && Queue.Num() == 1)
+	{
+		ChainActivateQueueHead();
+	}
+
+	RefreshTick();
+
+	CreatedScripts.Reset();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::AddScriptToQueueAt(class USimpleScript* Script, float Delay, bool bRealTime)
+{
+	if (!IsValid(Script))
+		return;
+
+	if (Delay <= 0.0f || !GetWorld())
+	{
+		AddScriptToQueueNow(Script);
+		return;
+	}
+
+	UpdateOccupancy(Script->GetScriptClassId(), 1);
+
+	PushTimer(Script, Delay, bRealTime);
+
+	OnScriptAdded.Broadcast(Script);
+
+	Script->OnAddedToQueue();
+
+	RefreshTick();
+
+	CreatedScripts.Reset();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+DEFINE_FUNCTION(UScriptQueueComponent::execNode_ApplySpawnParams)
+{
+	P_GET_OBJECT(USimpleScript, Script);
+	P_GET_OBJECT(UClass, Class);
+	P_GET_PROPERTY(FStrProperty, PropertyNames);
+
+	const int32 ClassId = FSimpleScriptClassRegistry::GetId(Class);
+
+	TSharedPtr<const TArray<const FProperty*>> Table;
+	if (ClassId != INDEX_NONE)
+	{
+		Table = FSimpleScriptClassRegistry::GetSpawnTable(ClassId, PropertyNames);
+	}
+
+	//The node only calls this for a created script of the class it was compiled against.
+	//The values can't be read without their properties, so a Blueprint compiled against a property that is gone stops here.
+	if (!IsValid(Script) || !Script->IsA(Class) || !Table.IsValid() || Table->Contains(nullptr))
+	{
+		FFrame::KismetExecutionMessage(*FString::Printf(TEXT("Create Script: can't apply the spawn values %s to %s, recompile the Blueprint"), *PropertyNames, *GetNameSafe(Class)), ELogVerbosity::Error);
+		Stack.bAbortingExecution = true;
+		return;
+	}
+
+	for (const FProperty *Property : *Table)
+	{
+		//The script VM writes bools as whole bytes, which would overwrite the neighbours of a bitfield
+		if (const FBoolProperty *BoolProperty = CastField<FBoolProperty>(Property))
+		{
+			bool bValue = false;
+			Stack.StepCompiledIn<FProperty>(&bValue);
+			BoolProperty->SetPropertyValue_InContainer(Script, bValue);
+			continue;
+		}
+
+		//Literal or variable, the value is copied right into the script
+		Stack.StepCompiledIn<FProperty>(Property->ContainerPtrToValuePtr<void>(Script));
+	}
+
+	P_FINISH;
 }
 
-/*
 //============================================================================================================
 //
 //============================================================================================================
-bool UScriptQueueComponent::CancelScriptsOfClass(class UObject* WorldContext, TSubclassOf<USimpleScript> Class, bool IncludeActive)
+TArray<class USimpleScript*> UScriptQueueComponent::Node_CreateScripts(class UObject* WorldContext, TSubclassOf<USimpleScript> Class, int32 Count, int32 RepeatCount)
 {
+	TArray<class USimpleScript*> Scripts;
+
 	class UScriptQueueComponent *pComponent = GetScriptQueueComponent(WorldContext);
-	if (!IsValid(pComponent))
-		return false;
+	if (IsValid(pComponent))
+	{
+		pComponent->CreateScripts(WorldContext, Class, Count, Scripts, RepeatCount);
+		pComponent->AddScriptsToQueue(Scripts);
+	}
 
-	return pComponent->CancelScriptsOfClass_Internal(Class, IncludeActive);
+	return Scripts;
 }
 
 //============================================================================================================
 //
 //============================================================================================================
-bool UScriptQueueComponent::CancelScriptsOfClass_Internal(TSubclassOf<USimpleScript> Class, bool IncludeActive)
+void UScriptQueueComponent::Node_AddSoftScriptToQueue(class UObject* WorldContext, TSoftClassPtr<USimpleScript> Class, int32 RepeatCount)
 {
-	if (IncludeActive)
+	class UScriptQueueComponent *pComponent = GetScriptQueueComponent(WorldContext);
+	if (IsValid(pComponent))
 	{
-		TArray<class USimpleScript*> InstantCopy = InstantScripts;
-		for (int32 i=0; i< InstantCopy.Num(); i++)
-		{
-			InstantCopy.GetData()[i]->Deactivate();
-		}
+		pComponent->AddSoftScriptToQueue(Class, RepeatCount);
 	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+class USimpleScript* UScriptQueueComponent::AddSoftScriptToQueue(TSoftClassPtr<USimpleScript> Class, int32 RepeatCount, TFunction<void(class USimpleScript*)> Initializer)
+{
+	if (Class.IsNull())
+		return NULL;
 
-	for (int32 i=Queue.Num()-1; i>=0; i--)
+	if (UClass *pClass = Class.Get())
 	{
-		if (i == 0)
+		class USimpleScript *pScript = CreateScript(this, pClass, RepeatCount);
+		if (pScript)
 		{
-			if (!IncludeActive)
-				continue;
+			if (Initializer)
+			{
+				Initializer(pScript);
+			}
 
-			Queue.GetData()[i]->Deactivate();
-			continue;
+			AddScriptToQueue(pScript);
 		}
 
-		Queue.
+		return pScript;
+	}
+
+	//Reserve the place in Queue, the slot itself is not announced with OnScriptAdded
+	class USimpleScriptLoadingSlot *pSlot = NewObject<USimpleScriptLoadingSlot>(this);
+	pSlot->ScriptClass = Class;
+	pSlot->RepeatCount = RepeatCount;
+	pSlot->Initializer = MoveTemp(Initializer);
+	pSlot->Initialize(this);
+
+	LoadingSlotCount++;
+	Queue.Add(pSlot);
+	RefreshTick();
+
+	pSlot->Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Class.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &UScriptQueueComponent::OnSoftScriptLoaded, TWeakObjectPtr<USimpleScriptLoadingSlot>(pSlot)));
+	if (!pSlot->Handle.IsValid())
+	{
+		//Bad path, don't leave the queue waiting on it
+		OnSoftScriptLoaded(pSlot);
 	}
+
+	return NULL;
 }
-*/
 
 //============================================================================================================
 //
 //============================================================================================================
-void UScriptQueueComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+void UScriptQueueComponent::OnSoftScriptLoaded(TWeakObjectPtr<USimpleScriptLoadingSlot> Slot)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	class USimpleScriptLoadingSlot *pSlot = Slot.Get();
+	if (!pSlot)
+		return;
 
-	if (Queue.Num() > 0)
+	//Cancelled while loading
+	const int32 Index = Queue.IndexOf(pSlot);
+	if (Index == INDEX_NONE)
+		return;
+
+	UClass *pClass = pSlot->ScriptClass.Get();
+	class USimpleScript *pScript = pClass ? CreateScript(this, pClass, pSlot->RepeatCount) : NULL;
+
+	if (pScript && pSlot->Initializer)
 	{
-		if (IsValid(Queue.GetData()[0]))
+		pSlot->Initializer(pScript);
+	}
+
+	pSlot->Initializer = nullptr;
+	pSlot->Handle.Reset();
+
+	LoadingSlotCount--;
+
+	if (pScript && !pScript->GetIsInstant() && !pScript->GetLane().IsValid() && pScript->PendingPrerequisites == 0 && pScript->GetStartDelay() <= 0.0f)
+	{
+		Queue.Replace(Index, pScript);
+		UpdateOccupancy(pScript->GetScriptClassId(), 1);
+
+		OnScriptAdded.Broadcast(pScript);
+
+		pScript->OnAddedToQueue();
+
+		CreatedScripts.Reset();
+	}
+	else
+	{
+		//Instant, lane, waiting and delayed scripts don't run in Queue order, they are added like any other script
+		Queue.RemoveAll([pSlot](const USimpleScript* Script) { return Script == pSlot; });
+
+		if (pScript)
 		{
-			Queue.GetData()[0]->Activate();
+			AddScriptToQueue(pScript);
 		}
-		else
+		else if (!HasQueue())
 		{
-			Queue.RemoveAt(0);
+			OnQueueFinished.Broadcast();
 		}
 	}
 
-	for (int32 i=InstantScripts.Num()-1; i>=0; i--)
+	if (Index == 0)
 	{
-		if (!IsValid(InstantScripts.GetData()[i]))
+		UpdatePreloads();
+		ChainActivateQueueHead();
+	}
+
+	RefreshTick();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::EnqueueFromAnyThread(TSoftClassPtr<USimpleScript> Class, TFunction<void(class USimpleScript*)> Initializer, int32 RepeatCount)
+{
+	FScriptEnqueueRequest Request;
+	Request.Class = MoveTemp(Class);
+	Request.RepeatCount = RepeatCount;
+	Request.Initializer = MoveTemp(Initializer);
+	Inbox.Enqueue(MoveTemp(Request));
+
+	if (bInboxArmed.exchange(true))
+		return;
+
+	if (IsInGameThread())
+	{
+		RefreshTick();
+		return;
+	}
+
+	//The component may be asleep, wake it up from the game thread
+	TWeakObjectPtr<UScriptQueueComponent> WeakThis(this);
+	AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+	{
+		if (class UScriptQueueComponent *pComponent = WeakThis.Get())
 		{
-			InstantScripts.RemoveAt(i);
+			pComponent->RefreshTick();
 		}
-	}
+	});
+}
 
-	TArray<class USimpleScript*> InstantCopy = InstantScripts;
-	for (int32 i=0; i<InstantCopy.Num(); i++)
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::DrainInbox()
+{
+	FScriptEnqueueRequest Request;
+	do
 	{
-		if (IsValid(InstantCopy.GetData()[i]))
+		while (Inbox.Dequeue(Request))
 		{
-			InstantCopy.GetData()[i]->Activate();
+			AddSoftScriptToQueue(Request.Class, Request.RepeatCount, MoveTemp(Request.Initializer));
 		}
+
+		//Disarm only when empty. A request enqueued while draining found the flag armed and scheduled no wake up,
+		//so look again after disarming, otherwise it would wait in the inbox with the flag left armed for good.
+		bInboxArmed.store(false);
 	}
+	while (!Inbox.IsEmpty());
 }
 
 //============================================================================================================
 //
 //============================================================================================================
-void UScriptQueueComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+void UScriptQueueComponent::AddPrerequisite(class USimpleScript* Script, class USimpleScript* Prerequisite)
 {
-	Super::EndPlay(EndPlayReason);
+	if (!IsValid(Script) || !IsValid(Prerequisite) || Script == Prerequisite || Prerequisite->bPrerequisiteDone || Script->IsActive())
+		return;
+
+	FSimpleScriptDependent Dependent;
+	Dependent.Script = Script;
+	Dependent.Serial = Script->Serial;
+	Prerequisite->Dependents.Add(Dependent);
+
+	Script->PendingPrerequisites++;
 }
 
 //============================================================================================================
 //
 //============================================================================================================
-bool UScriptQueueComponent::HasScriptInQueue(TSubclassOf<USimpleScript> Class) const
+class USimpleScript* UScriptQueueComponent::AddBarrier(const TArray<class USimpleScript*>& Prerequisites)
 {
-	for (int32 i=0; i<Queue.Num(); i++)
+	class USimpleScript *pBarrier = CreateScript(this, USimpleScriptBarrier::StaticClass());
+
+	for (class USimpleScript *pPrerequisite : Prerequisites)
 	{
-		if (IsValid(Queue.GetData()[i]) && Queue.GetData()[i]->GetClass() == Class)
-			return true;
+		AddPrerequisite(pBarrier, pPrerequisite);
 	}
 
-	for (int32 i = 0; i < InstantScripts.Num(); i++)
+	AddScriptToQueue(pBarrier);
+	return pBarrier;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::ReleaseDependents(class USimpleScript* Script)
+{
+	Script->bPrerequisiteDone = true;
+
+	if (Script->Dependents.Num() == 0)
+		return;
+
+	//Scripts that were reused from the pool since, or were cancelled, are skipped
+	const TArray<FSimpleScriptDependent> Dependents = MoveTemp(Script->Dependents);
+	Script->Dependents.Reset();
+
+	for (const FSimpleScriptDependent &Dependent : Dependents)
 	{
-		if (IsValid(InstantScripts.GetData()[i]) && InstantScripts.GetData()[i]->GetClass() == Class)
-			return true;
+		class USimpleScript *pDependent = Dependent.Script.Get();
+		if (!pDependent || pDependent->Serial != Dependent.Serial || pDependent->PendingPrerequisites <= 0)
+			continue;
+
+		if (--pDependent->PendingPrerequisites == 0 && WaitingScripts.RemoveSingleSwap(pDependent, EAllowShrinking::No) > 0)
+		{
+			InsertScript(pDependent);
+		}
 	}
 
-	return false;
+	RefreshTick();
 }
 
 //============================================================================================================
 //
 //============================================================================================================
-void UScriptQueueComponent::FinishScript(class USimpleScript *Script, bool Success)
+void UScriptQueueComponent::AddScriptsToQueue(const TArray<class USimpleScript*>& Scripts)
 {
-	if (!IsValid(Script))
-	{
+	if (Scripts.Num() == 0)
 		return;
-	}
 
-	if (PoolSize != 0 && Script->GetUsePool())
+	const bool bQueueWasEmpty = Queue.Num() == 0;
+
+	Queue.Reserve(Queue.Num() + Scripts.Num());
+	InstantScripts.Reserve(InstantScripts.Num() + Scripts.Num());
+
+	TArray<class USimpleScript*> Added;
+	Added.Reserve(Scripts.Num());
+
+	const bool bCanDelay = GetWorld() != NULL;
+	for (class USimpleScript *pScript : Scripts)
 	{
-		if (PoolSize > 0 && ScriptPool.Num() >= PoolSize)
+		if (!IsValid(pScript))
+			continue;
+
+		UpdateOccupancy(pScript->GetScriptClassId(), 1);
+
+		if (bCanDelay && pScript->GetStartDelay() > 0.0f)
+		{
+			PushTimer(pScript, pScript->GetStartDelay(), pScript->GetStartDelayRealTime());
+		}
+		else
 		{
-			ScriptPool.RemoveAt(0);
+			InsertScript(pScript);
 		}
 
-		ScriptPool.Add(Script);
+		Added.Add(pScript);
 	}
 
-	//Increase repeat counts
-	int32 iCurrent = Counts.Contains(Script->GetClass()) ? Counts[Script->GetClass()] : 0;
-	Counts.Emplace(Script->GetClass(), iCurrent+1);
-
-	if (Queue.Num() > 0 && Queue.GetData()[0] == Script)
+	//Everything is in the queues before any callbacks run
+	if (bBatchAddEvents)
 	{
-		Queue.RemoveAt(0);
+		OnScriptsAdded.Broadcast(Added);
 	}
-	else if (InstantScripts.Contains(Script))
+
+	for (class USimpleScript *pScript : Added)
 	{
-		InstantScripts.Remove(Script);
+		if (!bBatchAddEvents)
+		{
+			OnScriptAdded.Broadcast(pScript);
+		}
+
+		pScript->OnAddedToQueue();
 	}
 
-	if (InstantScripts.Num() == 0 && Queue.Num() == 0)
+	if (bQueueWasEmpty && Queue.Num() > 0)
 	{
-		OnQueueFinished.Broadcast();
-
-		PrimaryComponentTick.SetTickFunctionEnable(false);
+		UpdatePreloads();
+		ChainActivateQueueHead();
 	}
+
+	RefreshTick();
+
+	CreatedScripts.Reset();
 }
 
 //============================================================================================================
 //
 //============================================================================================================
-class USimpleScript* UScriptQueueComponent::Node_CreateScript(class UObject* WorldContext, TSubclassOf<USimpleScript> Class, int32 RepeatCount)
+void UScriptQueueComponent::PushTimer(class USimpleScript* Script, float Delay, bool bRealTime)
 {
-	if (!IsValid(Class))
+	FScriptTimerEntry Entry;
+	Entry.Script = Script;
+	Entry.DueTime = (bRealTime ? GetWorld()->GetRealTimeSeconds() : GetWorld()->GetTimeSeconds()) + Delay;
+	Entry.Sequence = ++TimerSequence;
+	(bRealTime ? RealTimers : GameTimers).HeapPush(Entry, FScriptTimerEntry());
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool UScriptQueueComponent::InsertScript(class USimpleScript* Script)
+{
+	if (Script->PendingPrerequisites > 0)
 	{
-		return NULL;
+		WaitingScripts.Add(Script);
+		return false;
 	}
 
-	UE_LOG(LogTemp, Display, TEXT("%s input count %d"), *Class->GetName(), RepeatCount);
-
-	class UScriptQueueComponent *pComponent = GetScriptQueueComponent(WorldContext);
-	if (!IsValid(pComponent))
+	if (Script->GetIsInstant())
 	{
-		return NULL;
+		InstantScripts.Add(Script);
+
+		if (Script->GetIsUrgent())
+		{
+			UrgentInstantScripts.Add(Script);
+		}
+		else
+		{
+			PendingInstantScripts.Add(Script);
+		}
+
+		return false;
 	}
 
-	if (RepeatCount > 0 && pComponent->GetRepeatCount(Class))
+	if (Script->GetLane().IsValid())
 	{
-		return NULL;
+		FScriptQueueLane &Lane = Lanes.FindOrAdd(Script->GetLane());
+
+		FScriptLaneEntry Entry;
+		Entry.Script = Script;
+		Entry.Priority = Script->GetPriority();
+		Entry.Sequence = ++LaneSequence;
+		Lane.Pending.HeapPush(Entry, FScriptLaneEntry());
+
+		Script->QueuedLane = Script->GetLane();
+		LaneScriptCount++;
+		bLanesIdle |= Lane.Active == NULL;
+
+		return false;
 	}
 
-	//Use one from pool if we have it
-	int32 i = INDEX_NONE;
-	for (int32 j=0; j<pComponent->ScriptPool.Num(); j++)
+	Queue.Add(Script);
+	return true;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::ProcessTimers()
+{
+	const class UWorld *pWorld = GetWorld();
+	if (!pWorld)
+		return;
+
+	if (GameTimers.Num() > 0)
 	{
-		if (pComponent->ScriptPool.GetData()[j]->GetClass() == Class)
-		{
-			i = pComponent->CreatedScripts.Add(pComponent->ScriptPool.GetData()[j]);
-			pComponent->ScriptPool.RemoveAt(j);
-			break;
-		}
+		ProcessTimers(GameTimers, pWorld->GetTimeSeconds());
 	}
 
-	if (i == INDEX_NONE)
+	if (RealTimers.Num() > 0)
 	{
-		i = pComponent->CreatedScripts.Add(NewObject<USimpleScript>(WorldContext, Class));
+		ProcessTimers(RealTimers, pWorld->GetRealTimeSeconds());
 	}
-
-	class USimpleScript *pScript = pComponent->CreatedScripts.GetData()[i];
-	pScript->Initialize(pComponent);
-	return pScript;
 }
 
 //============================================================================================================
 //
 //============================================================================================================
-void UScriptQueueComponent::Activate(bool bReset)
+bool UScriptQueueComponent::IsTimerDue() const
 {
-	Super::Activate();
+	const class UWorld *pWorld = GetWorld();
+	if (!pWorld)
+		return false;
 
-	PrimaryComponentTick.SetTickFunctionEnable(InstantScripts.Num() > 0 || Queue.Num() > 0);
+	return (GameTimers.Num() > 0 && GameTimers.HeapTop().DueTime <= pWorld->GetTimeSeconds()) ||
+		(RealTimers.Num() > 0 && RealTimers.HeapTop().DueTime <= pWorld->GetRealTimeSeconds());
 }
 
 //============================================================================================================
 //
 //============================================================================================================
-void UScriptQueueComponent::Deactivate()
+void UScriptQueueComponent::UpdateTimerWakes(bool bArm)
 {
-	Super::Deactivate();
+	class UWorld *pWorld = GetWorld();
+
+	//Only re-armed when the first timer changes, RefreshTick runs on every queue change
+	const double GameWake = (bArm && pWorld && GameTimers.Num() > 0) ? GameTimers.HeapTop().DueTime : -1.0;
+	if (GameWake != ArmedGameWake)
+	{
+		ArmedGameWake = GameWake;
+
+		if (pWorld)
+		{
+			if (GameWake < 0.0)
+			{
+				pWorld->GetTimerManager().ClearTimer(GameTimerWake);
+			}
+			else
+			{
+				const float Delay = FMath::Max((float)(GameWake - pWorld->GetTimeSeconds()), KINDA_SMALL_NUMBER);
+				pWorld->GetTimerManager().SetTimer(GameTimerWake, this, &UScriptQueueComponent::OnGameTimerWake, Delay, false);
+			}
+		}
+		else
+		{
+			GameTimerWake.Invalidate();
+		}
+	}
+
+	const double RealWake = (bArm && pWorld && RealTimers.Num() > 0) ? RealTimers.HeapTop().DueTime : -1.0;
+	if (RealWake != ArmedRealWake)
+	{
+		ArmedRealWake = RealWake;
 
-	PrimaryComponentTick.SetTickFunctionEnable(false);
+		if (RealTimerWake.IsValid())
+		{
+			FTSTicker::GetCoreTicker().RemoveTicker(RealTimerWake);
+			RealTimerWake.Reset();
+		}
+
+		//Game time dilation doesn't slow the core ticker down
+		if (RealWake >= 0.0)
+		{
+			const float Delay = FMath::Max((float)(RealWake - pWorld->GetRealTimeSeconds()), KINDA_SMALL_NUMBER);
+			RealTimerWake = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UScriptQueueComponent::OnRealTimerWake), Delay);
+		}
+	}
 }
 
 //============================================================================================================
 //
 //============================================================================================================
-void UScriptQueueComponent::AddScriptToQueue(class USimpleScript* Script)
+void UScriptQueueComponent::OnGameTimerWake()
 {
-	if (!IsValid(Script))
+	//Armed again if the tick goes back to sleep with timers left
+	ArmedGameWake = -1.0;
+	RefreshTick();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::UpdateRunningCheck(bool bArm)
+{
+	class UWorld *pWorld = GetWorld();
+	if (!pWorld)
+	{
+		RunningCheck.Invalidate();
+		return;
+	}
+
+	FTimerManager &TimerManager = pWorld->GetTimerManager();
+
+	if (bArm && RunningCheckInterval > 0.0f && HasQueue())
+	{
+		//Looping, armed once for the whole time the tick sleeps
+		if (!TimerManager.TimerExists(RunningCheck))
+		{
+			TimerManager.SetTimer(RunningCheck, this, &UScriptQueueComponent::OnRunningCheck, RunningCheckInterval, true);
+		}
 		return;
+	}
 
-	if (Script->GetIsInstant())
+	TimerManager.ClearTimer(RunningCheck);
+}
+
+//============================================================================================================
+// Running scripts are only left through FinishScript. Destroying one without Deactivate skips that, and the
+// garbage collector clears the reference, so the lanes, the head and the instant scripts are checked here instead.
+//============================================================================================================
+void UScriptQueueComponent::OnRunningCheck()
+{
+	bool bLost = Queue.Num() > 0 && !IsValid(Queue.First());
+
+	//Running instant scripts are never seen by the tick again, they would keep HasQueue true
+	if (InstantScripts.Num() > 0 && CompactInstantScripts())
 	{
-		InstantScripts.Add(Script);
+		bLost = true;
+	}
 
-		OnScriptAdded.Broadcast(Script);
+	int32 iLaneScripts = 0;
+	for (TPair<FGameplayTag, FScriptQueueLane> &Pair : Lanes)
+	{
+		FScriptQueueLane &Lane = Pair.Value;
+		if (Lane.Active && !IsValid(Lane.Active))
+		{
+			Lane.Active = NULL;
+		}
 
-		Script->OnAddedToQueue();
+		bLanesIdle |= !Lane.Active && Lane.Pending.Num() > 0;
+		iLaneScripts += Lane.Pending.Num() + (Lane.Active ? 1 : 0);
+	}
 
-		PrimaryComponentTick.SetTickFunctionEnable(IsActive());
+	if (iLaneScripts != LaneScriptCount)
+	{
+		LaneScriptCount = iLaneScripts;
+		bLostScripts = true;
+		bLost = true;
 	}
-	else
+
+	if (WaitingScripts.RemoveAll([](const USimpleScript* Script) { return !IsValid(Script); }) > 0)
 	{
-		Queue.Add(Script);
+		bLostScripts = true;
+		bLost = true;
+	}
 
-		OnScriptAdded.Broadcast(Script);
+	if (!bLost)
+		return;
 
-		Script->OnAddedToQueue();
-	
-		PrimaryComponentTick.SetTickFunctionEnable(IsActive());
+	if (!HasQueue())
+	{
+		OnQueueFinished.Broadcast();
 	}
 
-	CreatedScripts.Reset();
+	RefreshTick();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool UScriptQueueComponent::OnRealTimerWake(float DeltaTime)
+{
+	ArmedRealWake = -1.0;
+	RealTimerWake.Reset();
+	RefreshTick();
+
+	//One shot
+	return false;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::ProcessTimers(TArray<FScriptTimerEntry>& Timers, double Now)
+{
+	//Only the entries that are due are touched
+	while (Timers.Num() > 0 && Timers.HeapTop().DueTime <= Now)
+	{
+		FScriptTimerEntry Entry;
+		Timers.HeapPop(Entry, FScriptTimerEntry(), EAllowShrinking::No);
+
+		if (IsValid(Entry.Script))
+		{
+			InsertScript(Entry.Script);
+		}
+		else
+		{
+			bLostScripts = true;
+		}
+	}
 }
 
 //============================================================================================================
@@ -292,3 +2138,30 @@ class USimpleScript *UScriptQueueComponent::Node_AddScriptToQueue(class USimpleS
 
 	return NULL;
 }
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueComponent::Node_AddScriptToQueueAndWait(class USimpleScript* Script, EScriptWaitResult& Result, FLatentActionInfo LatentInfo)
+{
+	Result = EScriptWaitResult::Failed;
+
+	//The node branches to Failed before this when the script was not created
+	class UWorld *pWorld = IsValid(Script) ? Script->GetWorld() : NULL;
+	if (!pWorld)
+		return;
+
+	//Still waiting for an earlier script from the same node, the new one is added without waiting like other latent nodes
+	FLatentActionManager &LatentManager = pWorld->GetLatentActionManager();
+	if (!Script->WaitAction && !LatentManager.FindExistingAction<FSimpleScriptWaitAction>(LatentInfo.CallbackTarget, LatentInfo.UUID))
+	{
+		//Before adding, a chained queue can start and finish the script right away
+		Script->WaitAction = new FSimpleScriptWaitAction(Script, Result, LatentInfo);
+		LatentManager.AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID, Script->WaitAction);
+	}
+
+	if (!Node_AddScriptToQueue(Script))
+	{
+		Script->FinishWaitAction(false);
+	}
+}
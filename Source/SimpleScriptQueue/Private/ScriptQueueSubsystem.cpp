@@ -0,0 +1,205 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "ScriptQueueSubsystem.h"
+#include "ScriptQueueComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+#include "UObject/UObjectIterator.h"
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueSubsystem::Deinitialize()
+{
+	//Not only the queues in QueuesByOwner, an actor can have more than one registered
+	for (class UScriptQueueComponent *pComponent : TObjectRange<UScriptQueueComponent>())
+	{
+		if (pComponent->QueueSubsystem == this)
+		{
+			pComponent->SubsystemIndex = INDEX_NONE;
+			pComponent->AwakeIndex = INDEX_NONE;
+			pComponent->QueueSubsystem = NULL;
+		}
+	}
+
+	Components.Reset();
+	AwakeComponents.Reset();
+	TickingComponents.Reset();
+	QueuesByOwner.Reset();
+	PlayerQueues.Reset();
+
+	Super::Deinitialize();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+TStatId UScriptQueueSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UScriptQueueSubsystem, STATGROUP_Tickables);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (AwakeComponents.Num() == 0)
+		return;
+
+	TickingComponents.Reset();
+	TickingComponents.Append(AwakeComponents);
+
+	for (class UScriptQueueComponent *pComponent : TickingComponents)
+	{
+		//Could have gone to sleep because of an earlier component
+		if (IsValid(pComponent) && pComponent->AwakeIndex != INDEX_NONE)
+		{
+			pComponent->ProcessQueue(DeltaTime);
+		}
+	}
+
+	TickingComponents.Reset();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueSubsystem::RegisterComponent(class UScriptQueueComponent* Component, bool bTick)
+{
+	if (class AActor *pOwner = Component->GetOwner())
+	{
+		//The first queue of the actor is kept, like FindComponentByClass did
+		TWeakObjectPtr<UScriptQueueComponent> &Queue = QueuesByOwner.FindOrAdd(pOwner);
+		if (!Queue.IsValid())
+		{
+			Queue = Component;
+			PlayerQueues.Reset();
+		}
+	}
+
+	if (!bTick || Component->SubsystemIndex != INDEX_NONE)
+		return;
+
+	Component->SubsystemIndex = Components.Add(Component);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueSubsystem::UnregisterComponent(class UScriptQueueComponent* Component)
+{
+	if (class AActor *pOwner = Component->GetOwner())
+	{
+		const TWeakObjectPtr<UScriptQueueComponent> *pQueue = QueuesByOwner.Find(pOwner);
+		if (pQueue && (!pQueue->IsValid() || pQueue->Get() == Component))
+		{
+			QueuesByOwner.Remove(pOwner);
+		}
+	}
+
+	PlayerQueues.Reset();
+
+	SetComponentAwake(Component, false);
+
+	const int32 Index = Component->SubsystemIndex;
+	if (Index == INDEX_NONE)
+		return;
+
+	Components.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (Components.IsValidIndex(Index) && Components.GetData()[Index])
+	{
+		Components.GetData()[Index]->SubsystemIndex = Index;
+	}
+
+	Component->SubsystemIndex = INDEX_NONE;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void UScriptQueueSubsystem::SetComponentAwake(class UScriptQueueComponent* Component, bool bAwake)
+{
+	const int32 Index = Component->AwakeIndex;
+
+	if (bAwake)
+	{
+		if (Index == INDEX_NONE && Component->SubsystemIndex != INDEX_NONE)
+		{
+			Component->AwakeIndex = AwakeComponents.Add(Component);
+		}
+		return;
+	}
+
+	if (Index == INDEX_NONE)
+		return;
+
+	AwakeComponents.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (AwakeComponents.IsValidIndex(Index) && AwakeComponents.GetData()[Index])
+	{
+		AwakeComponents.GetData()[Index]->AwakeIndex = Index;
+	}
+
+	Component->AwakeIndex = INDEX_NONE;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+class UScriptQueueComponent* UScriptQueueSubsystem::FindQueueForActor(class AActor* Actor)
+{
+	if (!IsValid(Actor))
+		return NULL;
+
+	if (const TWeakObjectPtr<UScriptQueueComponent> *pQueue = QueuesByOwner.Find(Actor))
+	{
+		if (pQueue->IsValid())
+			return pQueue->Get();
+	}
+
+	//Never activated, or the map entry went stale
+	class UScriptQueueComponent *pComponent = Actor->FindComponentByClass<UScriptQueueComponent>();
+	if (pComponent)
+	{
+		QueuesByOwner.FindOrAdd(Actor) = pComponent;
+		return pComponent;
+	}
+
+	if (class APawn *pPawn = Cast<APawn>(Actor))
+	{
+		class AController *pController = pPawn->GetController();
+		if (pController && pController != Actor)
+			return FindQueueForActor(pController);
+	}
+
+	return NULL;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+class UScriptQueueComponent* UScriptQueueSubsystem::FindQueueForPlayer(int32 PlayerIndex)
+{
+	if (PlayerIndex < 0)
+		return NULL;
+
+	if (PlayerQueues.IsValidIndex(PlayerIndex) && PlayerQueues.GetData()[PlayerIndex].IsValid())
+		return PlayerQueues.GetData()[PlayerIndex].Get();
+
+	class UScriptQueueComponent *pComponent = FindQueueForActor(UGameplayStatics::GetPlayerController(GetWorld(), PlayerIndex));
+	if (pComponent)
+	{
+		if (PlayerQueues.Num() <= PlayerIndex)
+		{
+			PlayerQueues.SetNum(PlayerIndex + 1);
+		}
+
+		PlayerQueues.GetData()[PlayerIndex] = pComponent;
+	}
+
+	return pComponent;
+}
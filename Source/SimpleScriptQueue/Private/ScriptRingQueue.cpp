@@ -0,0 +1,116 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "ScriptRingQueue.h"
+#include "SimpleScript.h"
+
+//============================================================================================================
+//
+//============================================================================================================
+void FScriptRingQueue::Add(class USimpleScript* Script)
+{
+	if (Count == Storage.Num())
+	{
+		Resize(FMath::Max(8, Storage.Num() * 2));
+	}
+
+	Storage.GetData()[(Head + Count) & (Storage.Num() - 1)] = Script;
+	Count++;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+class USimpleScript* FScriptRingQueue::PopFront()
+{
+	check(Count > 0);
+
+	class USimpleScript* pScript = Storage.GetData()[Head];
+	Storage.GetData()[Head] = NULL;
+
+	Head = (Head + 1) & (Storage.Num() - 1);
+	Count--;
+
+	return pScript;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void FScriptRingQueue::Reserve(int32 Capacity)
+{
+	if (Capacity > Storage.Num())
+	{
+		Resize(FMath::RoundUpToPowerOfTwo(Capacity));
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void FScriptRingQueue::Reset()
+{
+	for (int32 i=0; i<Storage.Num(); i++)
+	{
+		Storage.GetData()[i] = NULL;
+	}
+
+	Head = 0;
+	Count = 0;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+bool FScriptRingQueue::Contains(const class USimpleScript* Script) const
+{
+	return IndexOf(Script) != INDEX_NONE;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 FScriptRingQueue::IndexOf(const class USimpleScript* Script) const
+{
+	for (int32 i=0; i<Count; i++)
+	{
+		if ((*this)[i] == Script)
+			return i;
+	}
+
+	return INDEX_NONE;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+TArray<class USimpleScript*> FScriptRingQueue::ToArray() const
+{
+	TArray<class USimpleScript*> Result;
+	Result.Reserve(Count);
+
+	for (int32 i=0; i<Count; i++)
+	{
+		Result.Add((*this)[i]);
+	}
+
+	return Result;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void FScriptRingQueue::Resize(int32 NewCapacity)
+{
+	TArray<class USimpleScript*> NewStorage;
+	NewStorage.SetNumZeroed(NewCapacity);
+
+	for (int32 i=0; i<Count; i++)
+	{
+		NewStorage.GetData()[i] = (*this)[i];
+	}
+
+	Storage = MoveTemp(NewStorage);
+	Head = 0;
+}
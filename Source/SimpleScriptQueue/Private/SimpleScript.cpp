@@ -4,6 +4,8 @@
 
 #include "SimpleScript.h"
 #include "ScriptQueueComponent.h"
+#include "SimpleScriptClassRegistry.h"
+#include "SimpleScriptWaitAction.h"
 
 //============================================================================================================
 //
@@ -13,6 +15,40 @@ USimpleScript::USimpleScript()
 	QueueComponent = NULL;
 }
 
+//============================================================================================================
+//
+//============================================================================================================
+void USimpleScript::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		ScriptClassId = FSimpleScriptClassRegistry::Register(GetClass());
+	}
+	else
+	{
+		ScriptClassId = GetClass()->GetDefaultObject<USimpleScript>()->ScriptClassId;
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+USimpleScriptLoadingSlot::USimpleScriptLoadingSlot()
+{
+	bUseScriptPool = false;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+USimpleScriptBarrier::USimpleScriptBarrier()
+{
+	bInstant = true;
+	bUrgent = true;
+}
+
 //=============================================================================================================================
 // 
 //=============================================================================================================================
@@ -53,9 +89,19 @@ class UWorld *USimpleScript::GetWorld() const
 //============================================================================================================
 bool USimpleScript::Initialize(class UScriptQueueComponent *InComponent)
 {
+	static uint32 NextSerial = 0;
+
 	if (IsValid(InComponent))
 	{
 		QueueComponent = InComponent;
+
+		Serial = ++NextSerial;
+		PendingPrerequisites = 0;
+		Dependents.Reset();
+		bPrerequisiteDone = false;
+		QueuedLane = FGameplayTag();
+		bWaitResultPending = false;
+		bPoolAfterWaitResult = false;
 		return true;
 	}
 
@@ -74,6 +120,11 @@ void USimpleScript::Activate()
 		QueueComponent->OnScriptStarted.Broadcast(this);
 		OnStarted.Broadcast(this);
 
+		if (WaitAction)
+		{
+			WaitAction->OnScriptStarted();
+		}
+
 		OnActivate();
 	}
 }
@@ -90,9 +141,153 @@ void USimpleScript::Deactivate(bool WasSuccess)
 
 		OnFinished.Broadcast(this, WasSuccess);
 		ClearAll();
+		FinishWaitAction(WasSuccess);
 		QueueComponent->OnScriptFinished.Broadcast(this, WasSuccess);
 
 		QueueComponent->FinishScript(this, WasSuccess);
 	}
 }
 
+//============================================================================================================
+//
+//============================================================================================================
+void USimpleScript::Cancel()
+{
+	if (bActive)
+	{
+		bActive = false;
+		OnDeactivate(false);
+	}
+
+	OnCancelled.Broadcast(this);
+	ClearAll();
+	FinishWaitAction(false);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void USimpleScript::FinishWaitAction(bool Success)
+{
+	//Cleared first, the script can be pooled and waited on again before the action next updates
+	if (class FSimpleScriptWaitAction *pAction = WaitAction)
+	{
+		WaitAction = NULL;
+		bWaitResultPending = true;
+		pAction->OnScriptFinished(Success);
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void USimpleScript::OnWaitResultReported()
+{
+	bWaitResultPending = false;
+
+	if (bPoolAfterWaitResult)
+	{
+		bPoolAfterWaitResult = false;
+
+		if (class UScriptQueueComponent *pComponent = QueueComponent.Get())
+		{
+			pComponent->ReleaseToPoolNextTick(this);
+		}
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void USimpleScript::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	if (ScriptClassId == INDEX_NONE)
+		return;
+
+	for (const FSoftObjectProperty *Property : FSimpleScriptClassRegistry::GetDefaults(ScriptClassId).SoftProperties)
+	{
+		for (int32 i=0; i<Property->ArrayDim; i++)
+		{
+			const FSoftObjectPtr &Value = *Property->GetPropertyValuePtr_InContainer(this, i);
+			if (!Value.IsNull())
+			{
+				OutAssets.Add(Value.ToSoftObjectPath());
+			}
+		}
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void FSimpleScriptResetSnapshot::Capture(const UClass* Class)
+{
+	Ranges.Reset();
+	Properties.Reset();
+
+	//Runtime state that is managed by the queue component
+	static const FName QueueComponentName = GET_MEMBER_NAME_CHECKED(USimpleScript, QueueComponent);
+	static const FName ActiveName = GET_MEMBER_NAME_CHECKED(USimpleScript, bActive);
+
+	TArray<TPair<int32, int32>> PodRanges;
+	for (TFieldIterator<FProperty> PropertyIt(Class, EFieldIteratorFlags::IncludeSuper); PropertyIt; ++PropertyIt)
+	{
+		const FProperty* Property = *PropertyIt;
+
+		if (Property->IsA(FMulticastDelegateProperty::StaticClass()) || Property->HasAnyPropertyFlags(CPF_Deprecated))
+			continue;
+
+		//Instanced subobjects belong to the script, copying would point it at the subobjects of the class default object
+		if (Property->HasAnyPropertyFlags(CPF_InstancedReference | CPF_PersistentInstance | CPF_ContainsInstancedReference))
+			continue;
+
+		if (Property->GetOwnerClass() == USimpleScript::StaticClass() && (Property->GetFName() == QueueComponentName || Property->GetFName() == ActiveName))
+			continue;
+
+		const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property);
+		const bool bBitfield = BoolProperty && !BoolProperty->IsNativeBool();
+
+		if (Property->HasAnyPropertyFlags(CPF_IsPlainOldData) && !bBitfield && !Property->IsA(FObjectPropertyBase::StaticClass()))
+		{
+			PodRanges.Emplace(Property->GetOffset_ForInternal(), Property->GetSize());
+		}
+		else
+		{
+			Properties.Add(Property);
+		}
+	}
+
+	PodRanges.Sort([](const TPair<int32, int32>& A, const TPair<int32, int32>& B) { return A.Key < B.Key; });
+
+	for (const TPair<int32, int32>& Range : PodRanges)
+	{
+		if (Ranges.Num() > 0 && Ranges.Last().Key + Ranges.Last().Value == Range.Key)
+		{
+			Ranges.Last().Value += Range.Value;
+		}
+		else
+		{
+			Ranges.Add(Range);
+		}
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void FSimpleScriptResetSnapshot::Apply(class USimpleScript* Script) const
+{
+	const UObject* Default = Script->GetClass()->GetDefaultObject();
+	uint8* Dest = reinterpret_cast<uint8*>(Script);
+	const uint8* Source = reinterpret_cast<const uint8*>(Default);
+
+	for (const TPair<int32, int32>& Range : Ranges)
+	{
+		FMemory::Memcpy(Dest + Range.Key, Source + Range.Key, Range.Value);
+	}
+
+	for (const FProperty* Property : Properties)
+	{
+		Property->CopyCompleteValue_InContainer(Dest, Source);
+	}
+}
@@ -0,0 +1,194 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "SimpleScriptClassRegistry.h"
+#include "SimpleScript.h"
+#include "UObject/CoreRedirects.h"
+
+TChunkedArray<FSimpleScriptClassInfo> FSimpleScriptClassRegistry::Classes;
+TMap<TObjectKey<UClass>, int32> FSimpleScriptClassRegistry::ClassToId;
+FRWLock FSimpleScriptClassRegistry::Lock;
+std::atomic<uint32> FSimpleScriptClassRegistry::Generation(0);
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 FSimpleScriptClassRegistry::Register(UClass* Class)
+{
+	FWriteScopeLock ScopeLock(Lock);
+
+	if (ClassToId.Contains(Class))
+		Generation.fetch_add(1, std::memory_order_relaxed);
+
+	const int32 Id = FindOrAdd(Class);
+
+	//Recompiled, the defaults and maybe the parent class changed
+	FSimpleScriptClassInfo &Info = Classes[Id];
+	Info.bDefaultsCached = false;
+	Info.SpawnTables.Reset();
+	Info.Ancestors.Reset();
+	Info.Ancestors.Add(Id);
+
+	if (Class != USimpleScript::StaticClass())
+	{
+		UClass *pSuper = Class->GetSuperClass();
+		if (pSuper && pSuper->IsChildOf(USimpleScript::StaticClass()))
+		{
+			const int32 SuperId = FindOrAdd(pSuper);
+			const TArray<int32> SuperAncestors = Classes[SuperId].Ancestors;
+			Classes[Id].Ancestors.Append(SuperAncestors);
+		}
+	}
+
+	return Id;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 FSimpleScriptClassRegistry::FindOrAdd(UClass* Class)
+{
+	if (const int32 *pId = ClassToId.Find(Class))
+		return *pId;
+
+	const int32 Id = Classes.Add(1);
+	Classes[Id].Class = Class;
+	Classes[Id].Ancestors.Add(Id);
+	ClassToId.Add(Class, Id);
+	return Id;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 FSimpleScriptClassRegistry::Num()
+{
+	FReadScopeLock ScopeLock(Lock);
+	return Classes.Num();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+const FSimpleScriptClassInfo& FSimpleScriptClassRegistry::Get(int32 Id)
+{
+	FReadScopeLock ScopeLock(Lock);
+	return Classes[Id];
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+TArray<int32> FSimpleScriptClassRegistry::GetAncestors(int32 Id)
+{
+	FReadScopeLock ScopeLock(Lock);
+	return Classes[Id].Ancestors;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+UClass* FSimpleScriptClassRegistry::GetClass(int32 Id)
+{
+	FReadScopeLock ScopeLock(Lock);
+	return Classes[Id].Class.Get();
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+int32 FSimpleScriptClassRegistry::GetId(const UClass* Class)
+{
+	if (!Class)
+		return INDEX_NONE;
+
+	const USimpleScript *pDefault = Cast<USimpleScript>(Class->GetDefaultObject());
+	return pDefault ? pDefault->GetScriptClassId() : INDEX_NONE;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+const FSimpleScriptClassInfo& FSimpleScriptClassRegistry::GetDefaults(int32 Id)
+{
+	{
+		FReadScopeLock ScopeLock(Lock);
+		if (Classes[Id].bDefaultsCached)
+			return Classes[Id];
+	}
+
+	FWriteScopeLock ScopeLock(Lock);
+
+	//Checked again, another thread may have filled it in between the locks
+	FSimpleScriptClassInfo &Info = Classes[Id];
+	if (!Info.bDefaultsCached)
+	{
+		if (const UClass *pClass = Info.Class.Get())
+		{
+			const USimpleScript *pDefault = pClass->GetDefaultObject<USimpleScript>();
+			Info.bInstant = pDefault->GetIsInstant();
+			Info.bUseScriptPool = pDefault->GetUsePool() && !pClass->HasAnyClassFlags(CLASS_Abstract);
+
+			Info.SoftProperties.Reset();
+			for (TFieldIterator<FSoftObjectProperty> PropertyIt(pClass, EFieldIteratorFlags::IncludeSuper); PropertyIt; ++PropertyIt)
+			{
+				if (!PropertyIt->HasAnyPropertyFlags(CPF_Deprecated | CPF_Transient))
+				{
+					Info.SoftProperties.Add(*PropertyIt);
+				}
+			}
+		}
+
+		Info.bDefaultsCached = true;
+	}
+
+	return Info;
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+TSharedPtr<const TArray<const FProperty*>> FSimpleScriptClassRegistry::GetSpawnTable(int32 Id, const FString& PropertyNames)
+{
+	{
+		FReadScopeLock ScopeLock(Lock);
+		if (const TSharedPtr<const TArray<const FProperty*>> *pTable = Classes[Id].SpawnTables.Find(PropertyNames))
+			return *pTable;
+	}
+
+	FWriteScopeLock ScopeLock(Lock);
+
+	//Cleared by Register when the class is recompiled
+	FSimpleScriptClassInfo &Info = Classes[Id];
+	if (const TSharedPtr<const TArray<const FProperty*>> *pTable = Info.SpawnTables.Find(PropertyNames))
+		return *pTable;
+
+	TArray<FString> Names;
+	PropertyNames.ParseIntoArray(Names, TEXT(","));
+
+	TSharedPtr<TArray<const FProperty*>> Table = MakeShared<TArray<const FProperty*>>();
+	Table->Reserve(Names.Num());
+
+	const UClass *pClass = Info.Class.Get();
+	for (const FString &Name : Names)
+	{
+		const FProperty *pProperty = pClass ? FindFProperty<FProperty>(pClass, *Name) : NULL;
+
+		//Blueprint compiled before the property was renamed
+		if (!pProperty && pClass)
+		{
+			const FCoreRedirectObjectName OldName(FName(*Name), pClass->GetFName(), pClass->GetOutermost()->GetFName());
+			const FCoreRedirectObjectName NewName = FCoreRedirects::GetRedirectedName(ECoreRedirectFlags::Type_Property, OldName);
+			if (NewName != OldName)
+			{
+				pProperty = FindFProperty<FProperty>(pClass, NewName.ObjectName);
+			}
+		}
+
+		Table->Add(pProperty);
+	}
+
+	Info.SpawnTables.Add(PropertyNames, Table);
+	return Table;
+}
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "SimpleScriptQueue.h"
+#include "SimpleScriptWaitAction.h"
 
 #define LOCTEXT_NAMESPACE "FSimpleScriptQueuetModule"
 
@@ -13,6 +14,7 @@ void FSimpleScriptQueueModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FSimpleScriptWaitAction::ReleaseFreeList();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,135 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "SimpleScriptWaitAction.h"
+
+TArray<void*> FSimpleScriptWaitAction::FreeList;
+
+//============================================================================================================
+//
+//============================================================================================================
+FSimpleScriptWaitAction::FSimpleScriptWaitAction(class USimpleScript* InScript, EScriptWaitResult& InResult, const FLatentActionInfo& LatentInfo)
+	: Script(InScript)
+	, Result(InResult)
+	, ExecutionFunction(LatentInfo.ExecutionFunction)
+	, OutputLink(LatentInfo.Linkage)
+	, CallbackTarget(LatentInfo.CallbackTarget)
+{
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+FSimpleScriptWaitAction::~FSimpleScriptWaitAction()
+{
+	//Aborted or the Blueprint was destroyed while the script still runs
+	class USimpleScript *pScript = Script.Get();
+	if (pScript && pScript->WaitAction == this)
+	{
+		pScript->WaitAction = NULL;
+	}
+
+	//Aborted after the script finished, before the result was reported
+	if (pScript && bFinished && !bReported)
+	{
+		pScript->OnWaitResultReported();
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void FSimpleScriptWaitAction::UpdateOperation(FLatentResponse& Response)
+{
+	if (bStartedPending)
+	{
+		bStartedPending = false;
+		Result = EScriptWaitResult::Started;
+		Response.TriggerLink(ExecutionFunction, OutputLink, CallbackTarget);
+		return;
+	}
+
+	//Script was garbage collected without finishing
+	if (!bFinished && !Script.IsValid())
+	{
+		bFinished = true;
+		bSucceeded = false;
+	}
+
+	if (bFinished)
+	{
+		Result = bSucceeded ? EScriptWaitResult::Succeeded : EScriptWaitResult::Failed;
+		Response.FinishAndTriggerIf(true, ExecutionFunction, OutputLink, CallbackTarget);
+
+		//The Blueprint resumes right after this update, the script is pooled on the next tick
+		if (class USimpleScript *pScript = Script.Get())
+		{
+			bReported = true;
+			pScript->OnWaitResultReported();
+		}
+	}
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void FSimpleScriptWaitAction::OnScriptFinished(bool bSuccess)
+{
+	//Kept, the script stays out of the pool until the result has been reported
+	bFinished = true;
+	bSucceeded = bSuccess;
+}
+
+#if WITH_EDITOR
+//============================================================================================================
+//
+//============================================================================================================
+FString FSimpleScriptWaitAction::GetDescription() const
+{
+	const class USimpleScript *pScript = Script.Get();
+	return FString::Printf(TEXT("Waiting for %s"), pScript ? *pScript->GetName() : TEXT("finished script"));
+}
+#endif
+
+//============================================================================================================
+//
+//============================================================================================================
+void* FSimpleScriptWaitAction::operator new(size_t Size)
+{
+	check(IsInGameThread() && Size == sizeof(FSimpleScriptWaitAction));
+
+	if (FreeList.Num() > 0)
+		return FreeList.Pop(EAllowShrinking::No);
+
+	return FMemory::Malloc(Size, alignof(FSimpleScriptWaitAction));
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void FSimpleScriptWaitAction::operator delete(void* Ptr)
+{
+	static const int32 MaxFree = 64;
+
+	if (Ptr && FreeList.Num() < MaxFree)
+	{
+		FreeList.Add(Ptr);
+		return;
+	}
+
+	FMemory::Free(Ptr);
+}
+
+//============================================================================================================
+//
+//============================================================================================================
+void FSimpleScriptWaitAction::ReleaseFreeList()
+{
+	for (void *Ptr : FreeList)
+	{
+		FMemory::Free(Ptr);
+	}
+
+	FreeList.Empty();
+}
@@ -0,0 +1,64 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ScriptClassManifest.generated.h"
+
+//============================================================================================================
+//
+//============================================================================================================
+USTRUCT(BlueprintType)
+struct SIMPLESCRIPTQUEUE_API FScriptClassManifestEntry
+{
+	GENERATED_BODY()
+
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Manifest")
+	TSoftClassPtr<class USimpleScript> Class;
+
+	//Create Script nodes spawning the class, counted once for every placed actor that has them
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Manifest", meta = (ClampMin = "0"))
+	int32 UseCount = 0;
+};
+
+//============================================================================================================
+// Script classes the Create Script nodes of one map spawn, written next to the map by the ScriptManifest
+// commandlet. Script queue components of the map read it to prewarm their pool and preload the classes.
+// Nothing references the manifests, they are cooked as primary assets of the type registered in the
+// plugin's Config/DefaultGame.ini.
+//============================================================================================================
+UCLASS(BlueprintType)
+class SIMPLESCRIPTQUEUE_API UScriptClassManifest : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	//
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+	//Type the asset manager scans and cooks the manifests under
+	static const FPrimaryAssetType PrimaryAssetType;
+
+	//Add uses of a class, merging with an existing entry
+	void AddUse(const TSoftClassPtr<class USimpleScript>& Class, int32 Count);
+
+	//Sort by use count so the most used classes are prewarmed first
+	void SortEntries();
+
+	//Package of the manifest of a map package
+	static FString GetManifestPackageName(const FString& MapPackageName);
+
+	//Manifest of the map the world was loaded from, invalid for worlds without a package
+	static FSoftObjectPath GetManifestPath(const class UWorld* World);
+
+public:
+
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Manifest")
+	TArray<FScriptClassManifestEntry> Entries;
+};
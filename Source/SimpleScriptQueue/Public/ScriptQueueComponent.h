@@ -7,10 +7,207 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "UObject/ObjectKey.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "Engine/TimerHandle.h"
+#include <atomic>
 #include "GameplayTagContainer.h"
 #include "SimpleScript.h"
+#include "ScriptRingQueue.h"
+#include "SimpleScriptClassRegistry.h"
+#include "ScriptClassManifest.h"
 #include "ScriptQueueComponent.generated.h"
 
+//============================================================================================================
+//
+//============================================================================================================
+USTRUCT()
+struct SIMPLESCRIPTQUEUE_API FScriptPoolBucket
+{
+	GENERATED_BODY()
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	TSubclassOf<class USimpleScript> Class;
+
+	//Free scripts of one class. Acquired from and released to the back.
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	TArray<class USimpleScript*> Scripts;
+
+	//Class ids of the next more and less recently used buckets, for evicting from the least recently used class.
+	//Only buckets with scripts are linked.
+	int32 NewerClassId = INDEX_NONE;
+	int32 OlderClassId = INDEX_NONE;
+
+	//Captured the first time a script of the class is returned to the pool
+	TSharedPtr<FSimpleScriptResetSnapshot> ResetSnapshot;
+
+	//Limit from PoolSizePerClass, -1 for none
+	int32 MaxSize = -1;
+
+	//
+	bool bInitialized = false;
+};
+
+//============================================================================================================
+// Class values copied out of FSimpleScriptClassRegistry the first time the component sees a class,
+// so the hot paths read them without taking the registry lock.
+//============================================================================================================
+struct FScriptQueueClassCache
+{
+	//Class id followed by the ids of its parent classes
+	TArray<int32> Ancestors;
+
+	//
+	bool bUseScriptPool = false;
+
+	//
+	bool bCached = false;
+};
+
+//============================================================================================================
+//
+//============================================================================================================
+USTRUCT(BlueprintType)
+struct SIMPLESCRIPTQUEUE_API FScriptPoolPrewarm
+{
+	GENERATED_BODY()
+
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pool")
+	TSubclassOf<class USimpleScript> Class;
+
+	//How many scripts of the class to create into the pool
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pool", meta = (ClampMin = "0"))
+	int32 Count = 1;
+};
+
+//============================================================================================================
+//
+//============================================================================================================
+USTRUCT()
+struct SIMPLESCRIPTQUEUE_API FScriptLaneEntry
+{
+	GENERATED_BODY()
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	class USimpleScript* Script = NULL;
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	int32 Priority = 0;
+
+	//Keeps scripts of the same priority in the order they were added
+	uint64 Sequence = 0;
+
+	//Heap predicate, true if A runs before B
+	FORCEINLINE bool operator()(const FScriptLaneEntry& A, const FScriptLaneEntry& B) const
+	{
+		return A.Priority > B.Priority || (A.Priority == B.Priority && A.Sequence < B.Sequence);
+	}
+};
+
+//============================================================================================================
+//
+//============================================================================================================
+USTRUCT()
+struct SIMPLESCRIPTQUEUE_API FScriptQueueLane
+{
+	GENERATED_BODY()
+
+	//Running script of the lane
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	class USimpleScript* Active = NULL;
+
+	//Waiting scripts as a binary heap, highest priority first
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	TArray<FScriptLaneEntry> Pending;
+};
+
+//============================================================================================================
+//
+//============================================================================================================
+USTRUCT()
+struct SIMPLESCRIPTQUEUE_API FScriptTimerEntry
+{
+	GENERATED_BODY()
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	class USimpleScript* Script = NULL;
+
+	//World time in seconds when the script goes into its queue
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	double DueTime = 0.0;
+
+	//Keeps scripts that are due at the same time in the order they were added
+	uint64 Sequence = 0;
+
+	//Heap predicate, true if A is due before B
+	FORCEINLINE bool operator()(const FScriptTimerEntry& A, const FScriptTimerEntry& B) const
+	{
+		return A.DueTime < B.DueTime || (A.DueTime == B.DueTime && A.Sequence < B.Sequence);
+	}
+};
+
+//============================================================================================================
+//
+//============================================================================================================
+struct SIMPLESCRIPTQUEUE_API FScriptPreload
+{
+	//NULL when the script has nothing to load
+	TSharedPtr<struct FStreamableHandle> Handle;
+
+	//Already counted in PreloadHits or PreloadStalls
+	bool bCounted = false;
+};
+
+//============================================================================================================
+//
+//============================================================================================================
+struct SIMPLESCRIPTQUEUE_API FScriptEnqueueRequest
+{
+	//Soft so the request can be made without touching the class on the producer thread
+	TSoftClassPtr<class USimpleScript> Class;
+
+	//
+	int32 RepeatCount = 0;
+
+	//Called on the game thread with the created script before it is added
+	TFunction<void(class USimpleScript*)> Initializer;
+};
+
+//============================================================================================================
+//
+//============================================================================================================
+UENUM(BlueprintType)
+enum class EScriptActivationBudget : uint8
+{
+	//Activate everything that is ready
+	None,
+
+	//Activate at most MaxActivationsPerFrame scripts per frame
+	Count,
+
+	//Activate scripts until ActivationBudgetMicroseconds has been used
+	Time,
+};
+
+//============================================================================================================
+//
+//============================================================================================================
+UENUM(BlueprintType)
+enum class EScriptQueueTickMode : uint8
+{
+	//Ticked together with all the other queues of the world by UScriptQueueSubsystem
+	Subsystem,
+
+	//Ticked by the component's own tick function
+	Component,
+};
+
 //============================================================================================================
 //
 //============================================================================================================
@@ -28,10 +225,26 @@ public:
 	virtual void Activate(bool bReset = false) override;
 	virtual void Deactivate() override;
 
-	//
+	//Queue of the first local player
 	UFUNCTION(BlueprintCallable, meta = (WorldContext="WorldContext"))
 	static class UScriptQueueComponent* GetScriptQueueComponent(class UObject* WorldContext);
 
+	//Queue on the player controller of a local player, for split screen
+	UFUNCTION(BlueprintCallable, meta = (WorldContext="WorldContext"))
+	static class UScriptQueueComponent* GetScriptQueueComponentForPlayer(class UObject* WorldContext, int32 PlayerIndex);
+
+	//Queue on the actor, or on the controller of a pawn without one
+	UFUNCTION(BlueprintCallable)
+	static class UScriptQueueComponent* GetScriptQueueComponentForActor(class AActor* Actor);
+
+	//Create a script for this queue, from the pool if possible. NULL if the repeat count of the class is used up.
+	//The script still needs to be added with AddScriptToQueue. Scripts of pooled classes are always outered to the component,
+	//like the prewarmed ones, since they outlive the caller and are handed out again.
+	class USimpleScript* CreateScript(class UObject* Outer, TSubclassOf<USimpleScript> Class, int32 RepeatCount = 0);
+
+	//Same as CreateScript for Count scripts, taking as many as possible from the pool at once. Appends to OutScripts.
+	void CreateScripts(class UObject* Outer, TSubclassOf<USimpleScript> Class, int32 Count, TArray<class USimpleScript*>& OutScripts, int32 RepeatCount = 0);
+
 	//
 	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContext", UnsafeDuringActorConstruction = "true", BlueprintInternalUseOnly = "true"))
 	static class USimpleScript *Node_CreateScript(class UObject* WorldContext, TSubclassOf<USimpleScript> Class, UPARAM(meta=(MinClamp="0")) int32 RepeatCount = 0);
@@ -40,12 +253,47 @@ public:
 	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContext", UnsafeDuringActorConstruction = "true", BlueprintInternalUseOnly = "true"))
 	static class USimpleScript* Node_AddScriptToQueue(class USimpleScript *Script);
 
-	//
-	/*
-	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContext", UnsafeDuringActorConstruction = "true", BlueprintInternalUseOnly = "true"))
-	static bool CancelScriptsOfClass(class UObject* WorldContext, TSubclassOf<USimpleScript> Class, bool IncludeActive = true);
-	bool CancelScriptsOfClass_Internal(TSubclassOf<USimpleScript> Class, bool IncludeActive);
-	*/
+	//Add the script like Node_AddScriptToQueue and resume through Started, then Succeeded or Failed. For the Create Script and Wait node.
+	//One wait per node and target at a time: running the node again before the first script finishes adds the new script without waiting for it.
+	UFUNCTION(BlueprintCallable, meta = (Latent, LatentInfo = "LatentInfo", ExpandEnumAsExecs = "Result", UnsafeDuringActorConstruction = "true", BlueprintInternalUseOnly = "true"))
+	static void Node_AddScriptToQueueAndWait(class USimpleScript *Script, EScriptWaitResult& Result, FLatentActionInfo LatentInfo);
+
+	//Sets the spawn values of a Create Script node in one call. The values follow PropertyNames as variadic parameters,
+	//each one is written straight into the script through the property table cached for Class. If the class no longer has
+	//one of the properties, the error is logged and the Blueprint stops here.
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (Variadic, BlueprintInternalUseOnly = "true"))
+	static void Node_ApplySpawnParams(class USimpleScript* Script, TSubclassOf<USimpleScript> Class, const FString& PropertyNames);
+	DECLARE_FUNCTION(execNode_ApplySpawnParams);
+
+	//Create and add Count scripts of the class in one go. Returns the scripts that were added.
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContext", UnsafeDuringActorConstruction = "true", DisplayName = "Create Scripts"))
+	static TArray<class USimpleScript*> Node_CreateScripts(class UObject* WorldContext, TSubclassOf<USimpleScript> Class, UPARAM(meta=(MinClamp="1")) int32 Count = 1, UPARAM(meta=(MinClamp="0")) int32 RepeatCount = 0);
+
+	//Create and add a script without a hard reference to its class. The class loads asynchronously, and the script keeps
+	//its place in the queue while it loads. Spawn values can't be set because the class is not known before it has loaded.
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContext", UnsafeDuringActorConstruction = "true", DisplayName = "Create Soft Script"))
+	static void Node_AddSoftScriptToQueue(class UObject* WorldContext, TSoftClassPtr<USimpleScript> Class, UPARAM(meta=(MinClamp="0")) int32 RepeatCount = 0);
+
+	//Same as Node_AddSoftScriptToQueue. Initializer is called on the script before it is added.
+	//Returns the script if the class was already loaded, otherwise NULL and the script is added later.
+	class USimpleScript* AddSoftScriptToQueue(TSoftClassPtr<USimpleScript> Class, int32 RepeatCount = 0, TFunction<void(class USimpleScript*)> Initializer = nullptr);
+
+	//Cancel waiting, and optionally running, scripts of the class. Returns how many were cancelled.
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContext", UnsafeDuringActorConstruction = "true"))
+	static int32 CancelScriptsOfClass(class UObject* WorldContext, TSubclassOf<USimpleScript> Class, bool IncludeSubclasses = false, bool IncludeActive = true);
+	int32 CancelScriptsOfClass_Internal(TSubclassOf<USimpleScript> Class, bool IncludeSubclasses, bool IncludeActive);
+
+	//If the script, or the script a loading slot is loading, is of the class
+	static bool IsScriptOfClass(const class USimpleScript* Script, const UClass* Class, bool IncludeSubclasses);
+
+	//Cancel waiting, and optionally running, scripts that have the tag. Returns how many were cancelled.
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContext", UnsafeDuringActorConstruction = "true"))
+	static int32 CancelScriptsWithTag(class UObject* WorldContext, FGameplayTag Tag, bool IncludeActive = true);
+	int32 CancelScriptsWithTag_Internal(FGameplayTag Tag, bool IncludeActive);
+
+	//Cancel every script the predicate returns true for, in one pass over all the queues.
+	//Cancelled scripts do not count towards repeat counts and are returned to the pool.
+	int32 CancelScripts(TFunctionRef<bool(const USimpleScript*)> Predicate, bool IncludeActive = true);
 
 public:
 
@@ -53,18 +301,54 @@ public:
 	UFUNCTION(BlueprintPure)
 	bool HasQueue() const;
 
-	//
+	//If a script of the class is waiting or running. Optionally also counts scripts of child classes.
 	UFUNCTION(BlueprintPure)
-	bool HasScriptInQueue(TSubclassOf<USimpleScript> Class) const;
+	bool HasScriptInQueue(TSubclassOf<USimpleScript> Class, bool IncludeSubclasses = false) const;
+
+	//Copy of the scripts waiting in the serial queue, the running one first.
+	//Replaces reading the Queue variable, which is a ring buffer now and no longer visible to Blueprints.
+	UFUNCTION(BlueprintPure, meta = (Keywords = "Queue"))
+	TArray<class USimpleScript*> GetQueue() const { return Queue.ToArray(); }
+
+	//Script running in a lane, NULL if the lane is idle
+	UFUNCTION(BlueprintPure)
+	class USimpleScript* GetLaneScript(FGameplayTag Lane) const;
 
 public:
 
 	//
 	void FinishScript(class USimpleScript *Script, bool Success);
 
-	//
+	//A script with a start delay waits it out in the timer heaps first, like with AddScriptToQueueAt
 	void AddScriptToQueue(class USimpleScript* Script);
 
+	//Safe to call from any thread. The script is created and added on the game thread the next time the queue is processed,
+	//requests from the same thread keep their order. The caller has to make sure the component is still alive.
+	void EnqueueFromAnyThread(TSoftClassPtr<USimpleScript> Class, TFunction<void(class USimpleScript*)> Initializer = nullptr, int32 RepeatCount = 0);
+
+	//Keep Script out of its queue until Prerequisite has finished or been cancelled. Call before adding Script to the queue.
+	//Scripts whose prerequisites are all done are activated together, so instant scripts with prerequisites run as a graph.
+	UFUNCTION(BlueprintCallable)
+	void AddPrerequisite(class USimpleScript* Script, class USimpleScript* Prerequisite);
+
+	//Add a script that finishes once all the prerequisites are done, for other scripts to wait on
+	UFUNCTION(BlueprintCallable)
+	class USimpleScript* AddBarrier(const TArray<class USimpleScript*>& Prerequisites);
+
+	//AddScriptToQueue for many scripts, with the queue bookkeeping done once for the whole batch
+	UFUNCTION(BlueprintCallable)
+	void AddScriptsToQueue(const TArray<class USimpleScript*>& Scripts);
+
+	//Add the script to its queue after Delay seconds of game time, or of real time that keeps going while the game is slowed down.
+	//Until then it only waits in a timer heap, it counts as queued but is not activated or ticked.
+	//Scripts are only added while the world ticks, a real time delay that runs out while the game is paused is handled on unpause.
+	void AddScriptToQueueAt(class USimpleScript* Script, float Delay, bool bRealTime = false);
+
+private:
+
+	//AddScriptToQueue without the start delay
+	void AddScriptToQueueNow(class USimpleScript* Script);
+
 public:
 
 	//
@@ -73,33 +357,440 @@ public:
 	//
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 
+	//Activate whatever is ready, from TickComponent or UScriptQueueSubsystem
+	void ProcessQueue(float DeltaTime);
+
 	//
-	FORCEINLINE int32 GetRepeatCount(TSubclassOf<class USimpleScript> Class) const { return Counts.Contains(Class) ? Counts[Class] : 0; }
+	virtual void Serialize(FArchive& Ar) override;
+
+	//How many times scripts of exactly this class have finished. Replaces reading Counts, which is only filled in when saving.
+	UFUNCTION(BlueprintPure)
+	FORCEINLINE int32 GetRepeatCount(TSubclassOf<class USimpleScript> Class) const { return GetRepeatCountById(FSimpleScriptClassRegistry::GetId(Class)); }
+	FORCEINLINE int32 GetRepeatCountById(int32 ClassId) const { return RepeatCounts.IsValidIndex(ClassId) ? RepeatCounts.GetData()[ClassId] : 0; }
+
+	//Free scripts in the pool, of every class
+	UFUNCTION(BlueprintPure)
+	FORCEINLINE int32 GetPooledScriptCount() const { return PooledScriptCount; }
+
+	//Free scripts of exactly this class in the pool
+	UFUNCTION(BlueprintPure)
+	int32 GetPooledScriptCountOfClass(TSubclassOf<class USimpleScript> Class) const;
+
+	//Copy of the free scripts in the pool, of every class. Replaces reading the ScriptPool variable, which is split by class now.
+	UFUNCTION(BlueprintPure, meta = (Keywords = "ScriptPool"))
+	TArray<class USimpleScript*> GetPooledScripts() const;
+
+	//
+	UFUNCTION(BlueprintPure)
+	FORCEINLINE bool IsPrewarming() const { return bPrewarming; }
+
+	//Scripts created with NewObject because the pool had none of the class
+	UFUNCTION(BlueprintPure)
+	FORCEINLINE int32 GetColdCreationCount() const { return ColdCreations; }
+
+	//Same as GetColdCreationCount, without the scripts created while the pool was still prewarming. Shows what prewarming missed.
+	UFUNCTION(BlueprintPure)
+	FORCEINLINE int32 GetColdCreationAfterPrewarmCount() const { return ColdCreationsAfterPrewarm; }
+
+	//
+	UFUNCTION(BlueprintPure)
+	FORCEINLINE int32 GetTicksAvoidedCount() const { return TicksAvoided; }
+
+	//Queue heads whose assets were loaded by the time they activated
+	UFUNCTION(BlueprintPure)
+	FORCEINLINE int32 GetPreloadHitCount() const { return PreloadHits; }
+
+	//Queue heads that had to wait for their assets, or activated without them
+	UFUNCTION(BlueprintPure)
+	FORCEINLINE int32 GetPreloadStallCount() const { return PreloadStalls; }
 
 private:
 
+	//Take a free script of exactly this class from the pool, or NULL if there is none
+	class USimpleScript* AcquirePooledScript(int32 ClassId);
+
+	//Take up to Count free scripts of exactly this class from the pool. Returns how many were added to OutScripts.
+	int32 AcquirePooledScripts(int32 ClassId, int32 Count, TArray<class USimpleScript*>& OutScripts);
+
+	//Pool bucket of the class, PoolSizePerClass is looked up the first time
+	FScriptPoolBucket& GetPoolBucket(int32 ClassId);
+
+	//Put a finished script back into the pool. Returns false if the script was not pooled.
+	bool ReleaseToPool(class USimpleScript* Script, bool bReset = true);
+
+	//ReleaseToPool for a finished or cancelled script, unless a Create Script and Wait node still has to report its result
+	void ReleaseFinishedToPool(class USimpleScript* Script);
+
+	//ReleaseToPool after the Blueprint resumed by a Create Script and Wait node has run
+	void ReleaseToPoolNextTick(class USimpleScript* Script);
+
+	//Drop a script of the least recently used class
+	void EvictFromPool();
+
+	//Move the bucket of the class to the most recently used end of the pool use list
+	void TouchPoolBucket(int32 ClassId);
+
+	//Take the bucket out of the pool use list once it is empty
+	void UnlinkPoolBucket(int32 ClassId);
+
+	//Create prewarm scripts into the pool until the frame budget runs out
+	void TickPrewarm();
+
+	//Start loading the class manifest of the map, or ClassManifest if set
+	void RequestClassManifest();
+
+	//Load the classes of the manifest
+	void OnClassManifestLoaded(FSoftObjectPath Path);
+
+	//Add the manifest classes to the prewarm list
+	void OnManifestClassesLoaded(TArray<FScriptClassManifestEntry> Entries);
+
+	//Swap remove destroyed scripts from InstantScripts, true if there were any
+	bool CompactInstantScripts();
+
+	//Activate the queue head right away when chaining is on and the frame and recursion limits allow it
+	bool ChainActivateQueueHead();
+
+	//If one more script can be activated this tick
+	bool HasActivationBudget(uint64 StartCycles, int32 Activations) const;
+
+	//Start the highest priority script of every idle lane
+	void ActivateLanes(uint64 StartCycles, int32& Activations);
+
+	//Slot is not activated while loading, and the head only waits for its assets when bWaitForPreloadedAssets is set
+	FORCEINLINE bool CanActivateHead(class USimpleScript* Head) { return !Head->IsA<USimpleScriptLoadingSlot>() && CheckPreload(Head); }
+
+	//Replace the loading slot with the script, or drop it if the script could not be created
+	void OnSoftScriptLoaded(TWeakObjectPtr<class USimpleScriptLoadingSlot> Slot);
+
+	//Create and add the scripts requested from other threads
+	void DrainInbox();
+
+	//Count down the dependents of a finished or cancelled script and insert the ones that became ready
+	void ReleaseDependents(class USimpleScript* Script);
+
+	//Put the script into InstantScripts, its lane or Queue, or WaitingScripts if it has prerequisites. Returns true for Queue.
+	bool InsertScript(class USimpleScript* Script);
+
+	//Start loading the assets of the first PreloadLookahead scripts in Queue
+	void UpdatePreloads();
+
+	//Counts the preload stats the first time the head is about to activate. Returns false if the head has to wait for its assets.
+	bool CheckPreload(class USimpleScript* Head);
+
 	//
+	bool IsWaitingForPreload(const class USimpleScript* Script) const;
+
+	//Put the script into the game time or real time timer heap
+	void PushTimer(class USimpleScript* Script, float Delay, bool bRealTime);
+
+	//Move the scripts that are due from the timer heaps into their queues
+	void ProcessTimers();
+	void ProcessTimers(TArray<FScriptTimerEntry>& Timers, double Now);
+
+	//The top of either timer heap is due
+	bool IsTimerDue() const;
+
+	//Arm wake ups for the first game time and real time timers while the tick sleeps, clear them otherwise
+	void UpdateTimerWakes(bool bArm);
+
+	//
+	void OnGameTimerWake();
+
+	//Arm the running script check while the tick sleeps with scripts in the queue, clear it otherwise
+	void UpdateRunningCheck(bool bArm);
+
+	//Wake the tick if a running script was destroyed without finishing
+	void OnRunningCheck();
+	bool OnRealTimerWake(float DeltaTime);
+
+	//Grow the per class tables to cover every registered class
+	FORCEINLINE void GrowClassTables(int32 ClassId) { if (ClassId >= RepeatCounts.Num()) GrowClassTables(); }
+	void GrowClassTables();
+
+	//Cached registry values of the class, filled in the first time the class is seen
+	FORCEINLINE const FScriptQueueClassCache& GetClassCache(int32 ClassId)
+	{
+		GrowClassTables(ClassId);
+		if (ClassCacheGeneration != FSimpleScriptClassRegistry::GetGeneration())
+			ResetClassCache();
+
+		const FScriptQueueClassCache &Cache = ClassCache.GetData()[ClassId];
+		return Cache.bCached ? Cache : CacheClass(ClassId);
+	}
+	const FScriptQueueClassCache& CacheClass(int32 ClassId);
+	void ResetClassCache();
+
+	//Move the repeat counts between the saved Counts map and the RepeatCounts table
+	void CountsToRepeatCounts();
+	void RepeatCountsToCounts();
+
+	//Add to the waiting and running script counts of the class and all its parent classes
+	void UpdateOccupancy(int32 ClassId, int32 Delta);
+
+	//Count the waiting and running scripts again, after destroyed scripts were dropped from the queues
+	void RebuildOccupancy();
+
+	//True when there is something new to activate. Running scripts alone do not need the tick.
+	bool NeedsTick() const;
+
+	//Enable the tick only while NeedsTick, called whenever the queue changes
+	void RefreshTick();
+
+	//
+	void RegisterWithSubsystem();
+	void UnregisterFromSubsystem();
+
+	friend class UScriptQueueSubsystem;
+
+private:
+
+	//Compatibility option for ticking in the component's own tick group
+	UPROPERTY(Category="Tick", EditAnywhere)
+	EScriptQueueTickMode TickMode = EScriptQueueTickMode::Subsystem;
+
+	//Set while registered with the subsystem
+	UPROPERTY(Transient)
+	class UScriptQueueSubsystem* QueueSubsystem = NULL;
+
+	//Positions in the subsystem lists
+	int32 SubsystemIndex = INDEX_NONE;
+	int32 AwakeIndex = INDEX_NONE;
+
+private:
+
+	//Maximum number of pooled scripts across all classes. -1 means no limit, 0 disables pooling.
 	UPROPERTY(Category="Pool", EditAnywhere, meta=(ClampMin="-1"))
 	int32 PoolSize = 20;
 
-	//Queue
-	UPROPERTY(VisibleAnywhere, Category = "Runtime", BlueprintReadOnly, meta = (AllowPrivateAccess = true))
-	TArray<class USimpleScript*> ScriptPool;
+	//Optional per class limits, checked in addition to PoolSize. -1 means no limit, 0 disables pooling for the class.
+	UPROPERTY(Category="Pool", EditAnywhere, meta=(ClampMin="-1"))
+	TMap<TSubclassOf<class USimpleScript>, int32> PoolSizePerClass;
+
+	//Restore the class default values of pooled scripts when they are returned to the pool
+	UPROPERTY(Category="Pool", EditAnywhere)
+	bool bResetPooledScripts = true;
+
+	//Free scripts, indexed by class id
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	TArray<FScriptPoolBucket> ScriptPool;
+
+	//Total number of scripts in all the pool buckets
+	int32 PooledScriptCount = 0;
+
+	//Ends of the pool use list, class ids of the most and the least recently used bucket that has scripts
+	int32 NewestPoolClassId = INDEX_NONE;
+	int32 OldestPoolClassId = INDEX_NONE;
+
+	//Scripts created into the pool when the component activates
+	UPROPERTY(Category="Pool", EditAnywhere)
+	TArray<FScriptPoolPrewarm> PrewarmScripts;
+
+	//How much time prewarming can use per frame
+	UPROPERTY(Category="Pool", EditAnywhere, meta=(ClampMin="0", Units="ms"))
+	float PrewarmBudgetMs = 1.0f;
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	bool bPrewarming = false;
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	bool bPrewarmDone = false;
+
+	//Prewarm entry being created and how many of it are done
+	int32 PrewarmIndex = 0;
+	int32 PrewarmCreated = 0;
+
+	//Prewarm and preload the script classes the Create Script nodes of the map use, from the manifest written by the ScriptManifest commandlet.
+	//Meant for the one queue most scripts go to, such as the player queue. Prewarming still stops at PoolSize.
+	UPROPERTY(Category="Pool", EditAnywhere)
+	bool bUseClassManifest = false;
+
+	//Manifest to use instead of the one next to the map
+	UPROPERTY(Category="Pool", EditAnywhere, meta=(EditCondition="bUseClassManifest"))
+	TSoftObjectPtr<class UScriptClassManifest> ClassManifest;
+
+	//Most scripts of one manifest class to prewarm
+	UPROPERTY(Category="Pool", EditAnywhere, meta=(ClampMin="0", EditCondition="bUseClassManifest"))
+	int32 ManifestPrewarmLimit = 4;
+
+	//Manifest while it loads, then its classes for as long as the component is in play
+	TSharedPtr<struct FStreamableHandle> ManifestHandle;
+
+	//
+	bool bManifestRequested = false;
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Stats")
+	int32 ColdCreations = 0;
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Stats")
+	int32 ColdCreationsAfterPrewarm = 0;
+
+	//Frames the tick stayed off while scripts were still running
+	UPROPERTY(VisibleAnywhere, Category = "Stats")
+	int32 TicksAvoided = 0;
+
+	//
+	bool bTicklessWithQueue = false;
+	uint64 TicklessSinceFrame = 0;
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Stats")
+	int32 PreloadHits = 0;
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Stats")
+	int32 PreloadStalls = 0;
+
+private:
+
+	//How many scripts from the front of Queue have their assets loaded ahead of time. Off by default, 2 is enough to hide most loads.
+	UPROPERTY(Category="Preload", EditAnywhere, meta=(ClampMin="0"))
+	int32 PreloadLookahead = 0;
+
+	//Keep the queue head waiting until its assets are loaded, instead of letting it load them synchronously
+	UPROPERTY(Category="Preload", EditAnywhere, meta=(EditCondition="PreloadLookahead > 0"))
+	bool bWaitForPreloadedAssets = false;
+
+	//Loads of the scripts in the lookahead window, kept until the script finishes
+	TMap<TObjectKey<class USimpleScript>, FScriptPreload> Preloads;
+
+private:
+
+	//Start the next serial script in the same frame the previous one finished, and start an idle queue as soon as a script is added.
+	//Otherwise the queue head is activated on the next tick.
+	UPROPERTY(Category="Queue", EditAnywhere)
+	bool bChainQueue = false;
+
+	//How many serial scripts chaining can start in one frame. The rest start from the tick. -1 means no limit.
+	UPROPERTY(Category="Queue", EditAnywhere, meta=(ClampMin="-1", EditCondition="bChainQueue"))
+	int32 MaxChainedActivationsPerFrame = 16;
+
+	//How deep scripts that finish synchronously can chain into each other before the rest is left to the tick
+	UPROPERTY(Category="Queue", EditAnywhere, meta=(ClampMin="1", EditCondition="bChainQueue"))
+	int32 MaxChainDepth = 8;
+
+	//
+	uint64 ChainFrame = 0;
+	int32 ChainedActivations = 0;
+	int32 ChainDepth = 0;
+
+	//Broadcast OnScriptsCancelled once per cancel call instead of OnScriptCancelled for every script
+	UPROPERTY(Category="Queue", EditAnywhere)
+	bool bBatchCancelEvents = false;
+
+	//How often a sleeping queue checks that its running scripts still exist. A script destroyed without finishing
+	//would otherwise keep the queue waiting for it forever. 0 turns the check off.
+	UPROPERTY(Category="Queue", EditAnywhere, meta=(ClampMin="0", Units="s"))
+	float RunningCheckInterval = 1.0f;
+
+	//Broadcast OnScriptsAdded once per AddScriptsToQueue call instead of OnScriptAdded for every script
+	UPROPERTY(Category="Queue", EditAnywhere)
+	bool bBatchAddEvents = false;
+
+	//Limits how many scripts the tick activates per frame. Scripts over the budget wait for the next frame in the order they were added.
+	UPROPERTY(Category="Budget", EditAnywhere)
+	EScriptActivationBudget ActivationBudget = EScriptActivationBudget::None;
+
+	//
+	UPROPERTY(Category="Budget", EditAnywhere, meta=(ClampMin="1", EditCondition="ActivationBudget == EScriptActivationBudget::Count"))
+	int32 MaxActivationsPerFrame = 8;
+
+	//
+	UPROPERTY(Category="Budget", EditAnywhere, meta=(ClampMin="0", Units="us", EditCondition="ActivationBudget == EScriptActivationBudget::Time"))
+	float ActivationBudgetMicroseconds = 1000.0f;
 
 private:
 
 	//Queue
-	UPROPERTY(VisibleAnywhere, Category="Runtime", BlueprintReadOnly, meta=(AllowPrivateAccess=true))
-	TArray<class USimpleScript*> Queue;
+	UPROPERTY(VisibleAnywhere, Category="Runtime")
+	FScriptRingQueue Queue;
 
 	//
 	UPROPERTY(VisibleAnywhere, Category = "Runtime", BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	TArray<class USimpleScript*> InstantScripts;
 
+	//Instant scripts that have not been activated yet. They are also in InstantScripts.
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	FScriptRingQueue PendingInstantScripts;
+
+	//Same as PendingInstantScripts, but these ignore the activation budget
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	FScriptRingQueue UrgentInstantScripts;
+
+	//Serial queues for scripts with a lane tag. Each lane runs one script at a time, independent of Queue and the other lanes.
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	TMap<FGameplayTag, FScriptQueueLane> Lanes;
+
+	//Running and waiting scripts in all lanes
+	int32 LaneScriptCount = 0;
+
+	//
+	uint64 LaneSequence = 0;
+
+	//Some lane has waiting scripts and nothing running
+	bool bLanesIdle = false;
+
+	//Destroyed scripts were dropped without FinishScript, Occupancy is rebuilt by the next RefreshTick
+	bool bLostScripts = false;
+
+	//Enqueue requests from any thread, drained on the game thread
+	TQueue<FScriptEnqueueRequest, EQueueMode::Mpsc> Inbox;
+
+	//Set by the first request after a drain, so only that one schedules a wake up on the game thread
+	std::atomic<bool> bInboxArmed { false };
+
+	//Scripts waiting for their prerequisites, in no particular order
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	TArray<class USimpleScript*> WaitingScripts;
+
+	//Delayed scripts as binary heaps, the earliest due first
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	TArray<FScriptTimerEntry> GameTimers;
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	TArray<FScriptTimerEntry> RealTimers;
+
 	//
-	UPROPERTY(SaveGame, VisibleAnywhere, Category = "Runtime", BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	uint64 TimerSequence = 0;
+
+	//Wake ups for the first timers while the tick sleeps. Game time through the world timer manager, real time through the core ticker.
+	FTimerHandle GameTimerWake;
+	FTSTicker::FDelegateHandle RealTimerWake;
+
+	//Due time the wake ups are armed for, negative when not armed
+	double ArmedGameWake = -1.0;
+	double ArmedRealWake = -1.0;
+
+	//
+	FTimerHandle RunningCheck;
+
+	//Saved form of RepeatCounts, only written when the component is serialized. Use GetRepeatCount to read the counts.
+	UPROPERTY(SaveGame, VisibleAnywhere, Category = "Runtime")
 	TMap<TSubclassOf<class USimpleScript>, int32> Counts;
 
+	//How many times scripts of each class have finished, indexed by class id
+	TArray<int32> RepeatCounts;
+
+	//Waiting and running scripts by exact class, indexed by class id
+	TArray<int32> Occupancy;
+
+	//Waiting and running scripts of the class or any of its child classes, indexed by class id
+	TArray<int32> SubclassOccupancy;
+
+	//Loading slots in Queue. They are counted here instead of in the tables, their classes are not loaded yet.
+	int32 LoadingSlotCount = 0;
+
+	//Registry values of each class, indexed by class id
+	TArray<FScriptQueueClassCache> ClassCache;
+
+	//Registry generation the cache was filled in, a recompiled class empties the cache
+	uint32 ClassCacheGeneration = 0;
+
 public:
 
 	//
@@ -120,10 +811,17 @@ public:
 	//
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FScriptQueueSuccessEvent, class USimpleScript*, Script, bool, Success);
 
+	//
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FScriptQueueScriptsEvent, const TArray<class USimpleScript*>&, Scripts);
+
 	//
 	UPROPERTY(BlueprintAssignable)
 	FScriptQueueScriptEvent OnScriptAdded;
 
+	//Used instead of OnScriptAdded by AddScriptsToQueue when bBatchAddEvents is set
+	UPROPERTY(BlueprintAssignable)
+	FScriptQueueScriptsEvent OnScriptsAdded;
+
 	//
 	UPROPERTY(BlueprintAssignable)
 	FScriptQueueScriptEvent OnScriptStarted;
@@ -132,6 +830,10 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FScriptQueueScriptEvent OnScriptCancelled;
 
+	//Used instead of OnScriptCancelled when bBatchCancelEvents is set
+	UPROPERTY(BlueprintAssignable)
+	FScriptQueueScriptsEvent OnScriptsCancelled;
+
 	//
 	UPROPERTY(BlueprintAssignable)
 	FScriptQueueSuccessEvent OnScriptFinished;
@@ -149,7 +851,7 @@ public:
 //============================================================================================================
 FORCEINLINE bool UScriptQueueComponent::HasQueue() const
 {
-	return Queue.Num() > 0 || InstantScripts.Num() > 0;
+	return Queue.Num() > 0 || InstantScripts.Num() > 0 || LaneScriptCount > 0 || WaitingScripts.Num() > 0 || GameTimers.Num() > 0 || RealTimers.Num() > 0;
 }
 
 //============================================================================================================
@@ -158,7 +860,10 @@ FORCEINLINE bool UScriptQueueComponent::HasQueue() const
 FORCEINLINE void UScriptQueueComponent::ClearAllEvents(class UObject* Object)
 {
 	OnScriptAdded.RemoveAll(Object);
+	OnScriptsAdded.RemoveAll(Object);
 	OnScriptStarted.RemoveAll(Object);
+	OnScriptCancelled.RemoveAll(Object);
+	OnScriptsCancelled.RemoveAll(Object);
 	OnScriptFinished.RemoveAll(Object);
 	OnQueueFinished.RemoveAll(Object);
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ScriptQueueSubsystem.generated.h"
+
+//============================================================================================================
+// Ticks every script queue component of the world in one pass.
+// Only components that have something to activate are in the awake list, the rest cost nothing.
+// Also keeps the queues by owner so finding the queue of an actor or a player is a map lookup.
+//============================================================================================================
+UCLASS()
+class SIMPLESCRIPTQUEUE_API UScriptQueueSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//
+	virtual void Deinitialize() override;
+
+	//
+	virtual void Tick(float DeltaTime) override;
+
+	//
+	virtual TStatId GetStatId() const override;
+
+public:
+
+	//Every active queue is registered by its owner, bTick also adds it to the subsystem tick
+	void RegisterComponent(class UScriptQueueComponent* Component, bool bTick);
+
+	//
+	void UnregisterComponent(class UScriptQueueComponent* Component);
+
+	//Add or remove the component from the list that is ticked
+	void SetComponentAwake(class UScriptQueueComponent* Component, bool bAwake);
+
+	//
+	FORCEINLINE int32 GetNumComponents() const { return Components.Num(); }
+	FORCEINLINE int32 GetNumAwakeComponents() const { return AwakeComponents.Num(); }
+
+	//Queue owned by the actor, or by the controller of a pawn that has none
+	class UScriptQueueComponent* FindQueueForActor(class AActor* Actor);
+
+	//Queue on the player controller, cached until a queue is registered or unregistered
+	class UScriptQueueComponent* FindQueueForPlayer(int32 PlayerIndex);
+
+private:
+
+	//Every component using the subsystem tick
+	UPROPERTY()
+	TArray<class UScriptQueueComponent*> Components;
+
+	//Components that need the tick
+	UPROPERTY()
+	TArray<class UScriptQueueComponent*> AwakeComponents;
+
+	//Copy of AwakeComponents for the tick, components can fall asleep or wake others while processing
+	UPROPERTY()
+	TArray<class UScriptQueueComponent*> TickingComponents;
+
+	//Registered queues, and queues found on actors that never activated theirs
+	TMap<TObjectKey<class AActor>, TWeakObjectPtr<class UScriptQueueComponent>> QueuesByOwner;
+
+	//Resolved player queues by player index
+	TArray<TWeakObjectPtr<class UScriptQueueComponent>> PlayerQueues;
+};
@@ -0,0 +1,92 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ScriptRingQueue.generated.h"
+
+//============================================================================================================
+// FIFO of scripts with constant time push and pop front.
+// Storage is a power of two sized UPROPERTY array so garbage collection and the details panel still see it.
+// Slots that are not in use are always NULL.
+//============================================================================================================
+USTRUCT()
+struct SIMPLESCRIPTQUEUE_API FScriptRingQueue
+{
+	GENERATED_BODY()
+
+	//
+	FORCEINLINE int32 Num() const { return Count; }
+
+	//
+	FORCEINLINE class USimpleScript* First() const { check(Count > 0); return Storage.GetData()[Head]; }
+
+	//Script at a position counted from the front
+	FORCEINLINE class USimpleScript* operator[](int32 Index) const { check(Index >= 0 && Index < Count); return Storage.GetData()[(Head + Index) & (Storage.Num() - 1)]; }
+
+	//
+	void Add(class USimpleScript* Script);
+
+	//
+	class USimpleScript* PopFront();
+
+	//
+	void Reserve(int32 Capacity);
+
+	//
+	void Reset();
+
+	//
+	bool Contains(const class USimpleScript* Script) const;
+
+	//Position counted from the front, INDEX_NONE if the script is not in the queue
+	int32 IndexOf(const class USimpleScript* Script) const;
+
+	//Put another script into an existing position
+	FORCEINLINE void Replace(int32 Index, class USimpleScript* Script) { check(Index >= 0 && Index < Count); Storage.GetData()[(Head + Index) & (Storage.Num() - 1)] = Script; }
+
+	//Copy of the scripts in queue order
+	TArray<class USimpleScript*> ToArray() const;
+
+	//Remove every script the predicate returns true for, keeping the order of the rest. Returns how many were removed.
+	template<typename PredicateType>
+	int32 RemoveAll(PredicateType Predicate)
+	{
+		const int32 Mask = Storage.Num() - 1;
+
+		int32 iWrite = 0;
+		for (int32 iRead=0; iRead<Count; iRead++)
+		{
+			class USimpleScript *&Slot = Storage.GetData()[(Head + iRead) & Mask];
+			class USimpleScript *pScript = Slot;
+			Slot = NULL;
+
+			if (!Predicate(pScript))
+			{
+				Storage.GetData()[(Head + iWrite) & Mask] = pScript;
+				iWrite++;
+			}
+		}
+
+		const int32 iRemoved = Count - iWrite;
+		Count = iWrite;
+		return iRemoved;
+	}
+
+private:
+
+	//Move the contents to a new array of the given power of two size, starting from index zero
+	void Resize(int32 NewCapacity);
+
+	//
+	UPROPERTY(VisibleAnywhere, Category = "Runtime")
+	TArray<class USimpleScript*> Storage;
+
+	//
+	int32 Head = 0;
+
+	//
+	int32 Count = 0;
+};
@@ -5,8 +5,54 @@
 #pragma once
 
 #include "Engine/Classes/Engine/LatentActionManager.h"
+#include "GameplayTagContainer.h"
 #include "SimpleScript.generated.h"
 
+//============================================================================================================
+// Copy plan for resetting a pooled script to the values of its class default object.
+// Adjacent plain old data properties are merged into byte ranges and copied in bulk,
+// everything else is copied property by property.
+//============================================================================================================
+struct SIMPLESCRIPTQUEUE_API FSimpleScriptResetSnapshot
+{
+	//
+	void Capture(const UClass* Class);
+
+	//
+	void Apply(class USimpleScript* Script) const;
+
+private:
+
+	//Offset and size of the memcpy ranges
+	TArray<TPair<int32, int32>> Ranges;
+
+	//
+	TArray<const FProperty*> Properties;
+};
+
+//============================================================================================================
+//
+//============================================================================================================
+struct SIMPLESCRIPTQUEUE_API FSimpleScriptDependent
+{
+	//
+	TWeakObjectPtr<class USimpleScript> Script;
+
+	//Serial of the script when the prerequisite was added, so a pooled script that was reused is not released
+	uint32 Serial = 0;
+};
+
+//============================================================================================================
+//
+//============================================================================================================
+UENUM(BlueprintType)
+enum class EScriptWaitResult : uint8
+{
+	Started,
+	Succeeded,
+	Failed,
+};
+
 //============================================================================================================
 //
 //============================================================================================================
@@ -19,6 +65,9 @@ public:
 	//Constructor
 	USimpleScript();
 
+	//
+	virtual void PostInitProperties() override;
+
 	//
 	virtual bool Initialize(class UScriptQueueComponent* InComponent);
 
@@ -47,6 +96,11 @@ public:
 	void OnDeactivate(bool Success);
 	virtual void OnDeactivate_Implementation(bool Success) { }
 
+	//Called when the script finished and is about to be reset and put into the script pool
+	UFUNCTION(BlueprintNativeEvent)
+	void OnReturnedToPool();
+	virtual void OnReturnedToPool_Implementation() { }
+
 	//
 	virtual void Activate();
 
@@ -54,6 +108,13 @@ public:
 	UFUNCTION(BlueprintCallable)
 	virtual void Deactivate(bool Success = true);
 
+	//Called by the queue component after it has removed the script from its queues
+	virtual void Cancel();
+
+	//Assets the queue component starts loading while the script waits in the queue.
+	//By default every soft object and soft class property of the script that is set.
+	virtual void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
 	//============================================================================================================
 	//
 	//============================================================================================================
@@ -89,11 +150,57 @@ private:
 
 	mutable TWeakObjectPtr<UWorld> CachedWorld;
 
+	//
+	int32 ScriptClassId = INDEX_NONE;
+
+	//Changes every time the script is initialized
+	uint32 Serial = 0;
+
+	//Prerequisites that have not finished yet. The script waits outside the queues until this is zero.
+	int32 PendingPrerequisites = 0;
+
+	//Scripts that have this script as a prerequisite
+	TArray<FSimpleScriptDependent> Dependents;
+
+	//Finished or cancelled, it no longer holds anything back
+	bool bPrerequisiteDone = false;
+
+	//Lane the script was put into. Lane itself is a spawn value that the script can change and the pool reset restores.
+	FGameplayTag QueuedLane;
+
+	//Latent Create Script and Wait node waiting for this script, owned by the latent action manager
+	class FSimpleScriptWaitAction* WaitAction = NULL;
+
+	//Tell the waiting latent action the script finished and forget it
+	void FinishWaitAction(bool Success);
+
+	//A finished latent action has not reported the result yet, the script stays out of the pool until it has
+	bool bWaitResultPending = false;
+
+	//Finished while bWaitResultPending, the queue left returning it to the pool to OnWaitResultReported
+	bool bPoolAfterWaitResult = false;
+
+	//Called by the latent action once the Blueprint has been resumed with the result
+	void OnWaitResultReported();
+
+	friend struct FSimpleScriptResetSnapshot;
+	friend class UScriptQueueComponent;
+	friend class FSimpleScriptWaitAction;
+
 public:
 
 	//
 	FORCEINLINE bool GetIsInstant() const { return bInstant; }
 	FORCEINLINE bool GetUsePool() const { return bUseScriptPool; }
+	FORCEINLINE bool GetIsUrgent() const { return bUrgent; }
+	FORCEINLINE const FGameplayTag& GetLane() const { return Lane; }
+	FORCEINLINE int32 GetPriority() const { return Priority; }
+	FORCEINLINE const FGameplayTagContainer& GetScriptTags() const { return ScriptTags; }
+	FORCEINLINE float GetStartDelay() const { return StartDelay; }
+	FORCEINLINE bool GetStartDelayRealTime() const { return bStartDelayRealTime; }
+
+	//Dense id of the class from FSimpleScriptClassRegistry
+	FORCEINLINE int32 GetScriptClassId() const { return ScriptClassId; }
 
 	//============================================================================================================
 	//
@@ -121,8 +228,74 @@ protected:
 	//If the script should go into the "Queue" or "InstantScripts" array.
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ExposeOnSpawn=true), Category="Settings")
 	bool bInstant;
+
+	//Activated on the next tick even when the queue component has used its activation budget for the frame.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ExposeOnSpawn=true), Category="Settings")
+	bool bUrgent;
+
+	//Serial scripts with a lane run in that lane instead of "Queue", so they don't wait for scripts in other lanes.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ExposeOnSpawn=true), Category="Settings")
+	FGameplayTag Lane;
+
+	//Higher priority scripts run first within their lane. Scripts of the same priority run in the order they were added.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ExposeOnSpawn=true), Category="Settings")
+	int32 Priority = 0;
+
+	//For cancelling groups of scripts with CancelScriptsWithTag
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ExposeOnSpawn=true), Category="Settings")
+	FGameplayTagContainer ScriptTags;
+
+	//Seconds to wait before the script goes into its queue. Replaces instant scripts that poll the time until a deadline.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ExposeOnSpawn=true, ClampMin="0", Units="s"), Category="Settings")
+	float StartDelay = 0.0f;
+
+	//StartDelay is measured in real time instead of game time
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ExposeOnSpawn=true, EditCondition="StartDelay > 0"), Category="Settings")
+	bool bStartDelayRealTime = false;
 };
 
+//============================================================================================================
+// Keeps the place in Queue of a script whose class is still loading.
+// The queue does not activate it, it is replaced with the real script when the class has loaded.
+//============================================================================================================
+UCLASS(NotBlueprintable, NotBlueprintType, Transient)
+class SIMPLESCRIPTQUEUE_API USimpleScriptLoadingSlot : public USimpleScript
+{
+public:
+	GENERATED_BODY()
 
+	//Constructor
+	USimpleScriptLoadingSlot();
+
+	//Loading slots never run
+	virtual void Activate() override { }
+
+	//
+	TSoftClassPtr<class USimpleScript> ScriptClass;
+
+	//
+	int32 RepeatCount = 0;
+
+	//Called on the created script before it takes the place of the slot
+	TFunction<void(class USimpleScript*)> Initializer;
+
+	//
+	TSharedPtr<struct FStreamableHandle> Handle;
+};
 
+//============================================================================================================
+// Instant script that finishes as soon as it activates. Used as a join point that other scripts can depend on.
+//============================================================================================================
+UCLASS(NotBlueprintable)
+class SIMPLESCRIPTQUEUE_API USimpleScriptBarrier : public USimpleScript
+{
+public:
+	GENERATED_BODY()
+
+	//Constructor
+	USimpleScriptBarrier();
+
+	//
+	virtual void OnActivate_Implementation() override { Deactivate(true); }
+};
 
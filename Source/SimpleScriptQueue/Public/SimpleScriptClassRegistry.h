@@ -0,0 +1,93 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ChunkedArray.h"
+#include "UObject/ObjectKey.h"
+#include <atomic>
+
+//============================================================================================================
+//
+//============================================================================================================
+struct SIMPLESCRIPTQUEUE_API FSimpleScriptClassInfo
+{
+	//
+	TWeakObjectPtr<UClass> Class;
+
+	//Ids of the class itself and its parents up to USimpleScript
+	TArray<int32> Ancestors;
+
+	//Class default values, read the first time they are needed
+	bool bDefaultsCached = false;
+	bool bInstant = false;
+	bool bUseScriptPool = false;
+
+	//Soft object and soft class properties, for the default USimpleScript::GetPreloadAssets
+	TArray<const class FSoftObjectProperty*> SoftProperties;
+
+	//Resolved spawn properties by the comma separated property name list of a Create Script node.
+	//Shared so a table handed out stays alive when the map grows or the class is recompiled.
+	TMap<FString, TSharedPtr<const TArray<const FProperty*>>> SpawnTables;
+};
+
+//============================================================================================================
+// Gives every USimpleScript class a small dense id when its class default object is created,
+// so per class data can live in flat arrays instead of maps keyed by UClass.
+// Ids are never reused. A recompiled Blueprint keeps its id, a hot reloaded class gets a new one.
+// Class default objects can be created on the async loading thread, so every access takes Lock.
+// Hot paths shouldn't call in here, the queue component copies what it needs once per class.
+// Infos never move once added, references to them stay valid after the lock is released.
+// Spawn tables are not part of that, they are handed out as shared pointers.
+//============================================================================================================
+class SIMPLESCRIPTQUEUE_API FSimpleScriptClassRegistry
+{
+public:
+
+	//Called from the class default object. Refreshes the cached info if the class is already known.
+	static int32 Register(UClass* Class);
+
+	//
+	static int32 Num();
+
+	//
+	static const FSimpleScriptClassInfo& Get(int32 Id);
+
+	//Copy of the ancestor ids, made under the lock
+	static TArray<int32> GetAncestors(int32 Id);
+
+	//Id of a script class, INDEX_NONE for NULL
+	static int32 GetId(const UClass* Class);
+
+	//Cached class default values of the class
+	static const FSimpleScriptClassInfo& GetDefaults(int32 Id);
+
+	//
+	static UClass* GetClass(int32 Id);
+
+	//Changes when a known class is registered again, caches of the infos have to be refilled
+	static FORCEINLINE uint32 GetGeneration() { return Generation.load(std::memory_order_relaxed); }
+
+	//Properties of the class in the order of the comma separated list, NULL for names the class doesn't have. Resolved once per list.
+	//Renamed properties are found through their property redirects.
+	static TSharedPtr<const TArray<const FProperty*>> GetSpawnTable(int32 Id, const FString& PropertyNames);
+
+private:
+
+	//
+	static int32 FindOrAdd(UClass* Class);
+
+	//
+	static TChunkedArray<FSimpleScriptClassInfo> Classes;
+
+	//Only used when registering. Keyed by object key, a new class can get the address of a collected one.
+	static TMap<TObjectKey<UClass>, int32> ClassToId;
+
+	//Written when registering and when the lazily cached parts of an info are filled in
+	static FRWLock Lock;
+
+	//
+	static std::atomic<uint32> Generation;
+};
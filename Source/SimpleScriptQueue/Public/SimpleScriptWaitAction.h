@@ -0,0 +1,67 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LatentActions.h"
+#include "SimpleScript.h"
+
+//============================================================================================================
+// Latent action of the Create Script and Wait node. The script calls it directly when it starts and finishes,
+// the action resumes the Blueprint on its next update. Started and the result are triggered on separate updates
+// since both go through the same Result variable.
+// Allocated from a free list, the latent action manager deletes finished actions with plain delete.
+//============================================================================================================
+class SIMPLESCRIPTQUEUE_API FSimpleScriptWaitAction final : public FPendingLatentAction
+{
+public:
+
+	//
+	FSimpleScriptWaitAction(class USimpleScript* InScript, EScriptWaitResult& InResult, const FLatentActionInfo& LatentInfo);
+
+	//
+	virtual ~FSimpleScriptWaitAction();
+
+	//
+	virtual void UpdateOperation(FLatentResponse& Response) override;
+
+#if WITH_EDITOR
+	//
+	virtual FString GetDescription() const override;
+#endif
+
+	//Called by the script
+	FORCEINLINE void OnScriptStarted() { bStartedPending = true; }
+	void OnScriptFinished(bool bSuccess);
+
+	//
+	static void* operator new(size_t Size);
+	static void operator delete(void* Ptr);
+
+	//Give the free list back to the allocator, when the module shuts down
+	static void ReleaseFreeList();
+
+private:
+
+	//
+	TWeakObjectPtr<class USimpleScript> Script;
+
+	//Expanded into the exec outputs of the node
+	EScriptWaitResult& Result;
+
+	//
+	FName ExecutionFunction;
+	int32 OutputLink;
+	FWeakObjectPtr CallbackTarget;
+
+	//
+	bool bStartedPending = false;
+	bool bFinished = false;
+	bool bSucceeded = false;
+	bool bReported = false;
+
+	//Freed action memory, only touched on the game thread
+	static TArray<void*> FreeList;
+};
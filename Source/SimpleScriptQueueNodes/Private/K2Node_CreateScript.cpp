@@ -3,6 +3,7 @@
 // Do not use to train AI / LLM / neural network
 
 #include "K2Node_CreateScript.h"
+#include "SimpleScriptSpawnPinCache.h"
 #include "SimpleScript.h"
 #include "UObject/UnrealType.h"
 #include "EdGraphSchema_K2.h"
@@ -13,6 +14,8 @@
 #include "ScriptQueueComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "K2Node_CallFunction.h"
+#include "K2Node_IfThenElse.h"
+#include "Kismet/KismetSystemLibrary.h"
 #include "KismetCompilerMisc.h"
 #include "KismetCompiler.h"
 #include "K2Node_VariableGet.h"
@@ -28,6 +31,9 @@ struct FK2Node_SimpleScriptHelper
 	static FName AddScriptToQueue;
 	static FName CreateScript;
 	static FName RepeatCount;
+	static FName ApplySpawnParams;
+	static FName PropertyNames;
+	static FName FailedPinName;
 };
 
 FName FK2Node_SimpleScriptHelper::ClassPinName(TEXT("Class"));
@@ -35,6 +41,9 @@ FName FK2Node_SimpleScriptHelper::OuterPinName(TEXT("WorldContext"));
 FName FK2Node_SimpleScriptHelper::CreateScript(TEXT("Node_CreateScript"));
 FName FK2Node_SimpleScriptHelper::AddScriptToQueue(TEXT("Node_AddScriptToQueue"));
 FName FK2Node_SimpleScriptHelper::RepeatCount(TEXT("RepeatCount"));
+FName FK2Node_SimpleScriptHelper::ApplySpawnParams(TEXT("Node_ApplySpawnParams"));
+FName FK2Node_SimpleScriptHelper::PropertyNames(TEXT("PropertyNames"));
+FName FK2Node_SimpleScriptHelper::FailedPinName(TEXT("Failed"));
 
 //
 #define LOCTEXT_NAMESPACE "K2Node_CreateScript"
@@ -64,7 +73,7 @@ void UK2Node_CreateScript::AllocateDefaultPins()
 
 	// Add execution pins
 	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Execute);
-	CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Then);
+	AllocateExecOutputPins();
 
 	// If required add the world context pin
 	if (GetBlueprint()->ParentClass->HasMetaDataHierarchical(FBlueprintMetadata::MD_ShowWorldContextPin))
@@ -86,6 +95,45 @@ void UK2Node_CreateScript::AllocateDefaultPins()
 	Super::AllocateDefaultPins();
 }
 
+//=================================================================================================
+// 
+//=================================================================================================
+void UK2Node_CreateScript::AllocateExecOutputPins()
+{
+	CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Then);
+
+	// Taken instead of then when the repeat count is used up or there is no queue. Unconnected, then is used for both.
+	UEdGraphPin* FailedPin = CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, FK2Node_SimpleScriptHelper::FailedPinName);
+	FailedPin->PinToolTip = LOCTEXT("FailedPinDescription", "The script was not created").ToString();
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+FName UK2Node_CreateScript::GetAddScriptFunctionName() const
+{
+	return FK2Node_SimpleScriptHelper::AddScriptToQueue;
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+UEdGraphPin* UK2Node_CreateScript::ExpandAddScriptOutputs(FKismetCompilerContext& CompilerContext, UK2Node_CallFunction* CallAddNode, UEdGraphPin* ScriptPin)
+{
+	UEdGraphPin* SpawnNodeResult = GetResultPin();
+	UEdGraphPin* CallFinishThen = CallAddNode->GetThenPin();
+	UEdGraphPin* CallFinishResult = CallAddNode->GetReturnValuePin();
+
+	// Move 'then' connection from spawn node to 'finish spawn'
+	CompilerContext.MovePinLinksToIntermediate(*GetThenPin(), *CallFinishThen);
+
+	// Move result connection from spawn node to 'finish spawn'
+	CallFinishResult->PinType = SpawnNodeResult->PinType; // Copy type so it uses the right actor subclass
+	CompilerContext.MovePinLinksToIntermediate(*SpawnNodeResult, *CallFinishResult);
+
+	return CallFinishThen;
+}
+
 //=================================================================================================
 // 
 //=================================================================================================
@@ -132,43 +180,28 @@ void UK2Node_CreateScript::CreatePinsForClass(UClass* InClass, TArray<UEdGraphPi
 
 	const UEdGraphSchema_K2* K2Schema = GetDefault<UEdGraphSchema_K2>();
 
-	const UObject* const ClassDefaultObject = InClass->GetDefaultObject(false);
-
-	for (TFieldIterator<FProperty> PropertyIt(InClass, EFieldIteratorFlags::IncludeSuper); PropertyIt; ++PropertyIt)
+	// Property walk and default value strings are shared by all nodes of the class
+	for (const FSimpleScriptSpawnPin& SpawnPin : FSimpleScriptSpawnPinCache::Get(InClass))
 	{
-		FProperty* Property = *PropertyIt;
-		//UClass* PropertyClass = CastChecked<UClass>(Property->GetClass());
-		const bool bIsDelegate = Property->IsA(FMulticastDelegateProperty::StaticClass());
-		const bool bIsExposedToSpawn = UEdGraphSchema_K2::IsPropertyExposedOnSpawn(Property);
-		const bool bIsSettableExternally = !Property->HasAnyPropertyFlags(CPF_DisableEditOnInstance);
+		if (nullptr != FindPin(SpawnPin.PropertyName))
+		{
+			continue;
+		}
 
-		if (bIsExposedToSpawn &&
-			!Property->HasAnyPropertyFlags(CPF_Parm) &&
-			bIsSettableExternally &&
-			Property->HasAllPropertyFlags(CPF_BlueprintVisible) &&
-			!bIsDelegate &&
-			(nullptr == FindPin(Property->GetFName())) &&
-			FBlueprintEditorUtils::PropertyStillExists(Property))
+		if (UEdGraphPin* Pin = CreatePin(EGPD_Input, SpawnPin.PinType, SpawnPin.PropertyName))
 		{
-			if (UEdGraphPin* Pin = CreatePin(EGPD_Input, NAME_None, Property->GetFName()))
+			if (OutClassPins)
 			{
-				K2Schema->ConvertPropertyToPinType(Property, /*out*/ Pin->PinType);
-				if (OutClassPins)
-				{
-					OutClassPins->Add(Pin);
-				}
-
-				if (ClassDefaultObject && K2Schema->PinDefaultValueIsEditable(*Pin))
-				{
-					FString DefaultValueAsString;
-					const bool bDefaultValueSet = FBlueprintEditorUtils::PropertyValueToString(Property, reinterpret_cast<const uint8*>(ClassDefaultObject), DefaultValueAsString);
-					check(bDefaultValueSet);
-					K2Schema->SetPinAutogeneratedDefaultValue(Pin, DefaultValueAsString);
-				}
+				OutClassPins->Add(Pin);
+			}
 
-				// Copy tooltip from the property.
-				K2Schema->ConstructBasicPinTooltip(*Pin, Property->GetToolTipText(), Pin->PinToolTip);
+			if (SpawnPin.bHasDefaultValue && K2Schema->PinDefaultValueIsEditable(*Pin))
+			{
+				K2Schema->SetPinAutogeneratedDefaultValue(Pin, SpawnPin.DefaultValue);
 			}
+
+			// Copy tooltip from the property.
+			K2Schema->ConstructBasicPinTooltip(*Pin, SpawnPin.ToolTip, Pin->PinToolTip);
 		}
 	}
 
@@ -242,6 +275,7 @@ bool UK2Node_CreateScript::IsSpawnVarPin(UEdGraphPin* Pin) const
 {
 	return	Pin->PinName != UEdGraphSchema_K2::PN_Execute &&
 			Pin->PinName != UEdGraphSchema_K2::PN_Then &&
+			Pin->PinName != FK2Node_SimpleScriptHelper::FailedPinName &&
 			Pin->PinName != UEdGraphSchema_K2::PN_Self &&
 			Pin->PinName != UEdGraphSchema_K2::PN_ReturnValue &&
 			Pin->PinName != FK2Node_SimpleScriptHelper::ClassPinName &&
@@ -348,6 +382,16 @@ UEdGraphPin* UK2Node_CreateScript::GetThenPin()const
 	return Pin;
 }
 
+//=================================================================================================
+// 
+//=================================================================================================
+UEdGraphPin* UK2Node_CreateScript::GetFailedPin() const
+{
+	UEdGraphPin* Pin = FindPinChecked(FK2Node_SimpleScriptHelper::FailedPinName);
+	check(Pin->Direction == EGPD_Output);
+	return Pin;
+}
+
 //=================================================================================================
 // 
 //=================================================================================================
@@ -562,8 +606,6 @@ void UK2Node_CreateScript::ExpandNode(class FKismetCompilerContext& CompilerCont
 	UEdGraphPin* SpawnWorldContextPin = SpawnNode->GetOuterPin();
 
 	UEdGraphPin* SpawnClassPin = SpawnNode->GetClassPin();
-	UEdGraphPin* SpawnNodeThen = SpawnNode->GetThenPin();
-	UEdGraphPin* SpawnNodeResult = GetResultPin();
 	UEdGraphPin* SpawnNodeRepeatCount = GetRepeatCountPin();
 
 	//////////////////////////////////////////////////////////////////////////
@@ -654,39 +696,155 @@ void UK2Node_CreateScript::ExpandNode(class FKismetCompilerContext& CompilerCont
 
 	// create 'finish spawn' call node
 	UK2Node_CallFunction* CallAddScriptToQueue = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(SpawnNode, SourceGraph);
-	CallAddScriptToQueue->FunctionReference.SetExternalMember(FK2Node_SimpleScriptHelper::AddScriptToQueue, UScriptQueueComponent::StaticClass());
+	CallAddScriptToQueue->FunctionReference.SetExternalMember(GetAddScriptFunctionName(), UScriptQueueComponent::StaticClass());
 	CallAddScriptToQueue->AllocateDefaultPins();
 
 	static const FName ScriptName(TEXT("Script"));
 
 	UEdGraphPin* CallFinishExec = CallAddScriptToQueue->GetExecPin();
-	UEdGraphPin* CallFinishThen = CallAddScriptToQueue->GetThenPin();
 	UEdGraphPin* CallFinishActor = CallAddScriptToQueue->FindPinChecked(ScriptName);
-	UEdGraphPin* CallFinishResult = CallAddScriptToQueue->GetReturnValuePin();
-
-	// Move 'then' connection from spawn node to 'finish spawn'
-	CompilerContext.MovePinLinksToIntermediate(*SpawnNodeThen, *CallFinishThen);
 
 	// Connect output actor from 'begin' to 'finish'
 	CallBeginResult->MakeLinkTo(CallFinishActor);
 
-	// Move result connection from spawn node to 'finish spawn'
-	CallFinishResult->PinType = SpawnNodeResult->PinType; // Copy type so it uses the right actor subclass
-	CompilerContext.MovePinLinksToIntermediate(*SpawnNodeResult, *CallFinishResult);
+	// Move 'then' and result connections from spawn node to 'finish spawn'
+	UEdGraphPin* CallFinishThen = ExpandAddScriptOutputs(CompilerContext, CallAddScriptToQueue, CallBeginResult);
 
 	//////////////////////////////////////////////////////////////////////////
 	// create 'set var' nodes
 
 	// Get 'result' pin from 'begin spawn', this is the actual actor we want to set properties on
-	UEdGraphPin* LastThen = FKismetCompilerUtilities::GenerateAssignmentNodes(CompilerContext, SourceGraph, CallBeginSpawnNode, SpawnNode, CallBeginResult, ClassToSpawn);
+	UEdGraphPin* LastThen = bNativeSpawnParams ? ExpandNativeSpawnParams(CompilerContext, SourceGraph, CallBeginSpawnNode, CallBeginResult, ClassToSpawn) : NULL;
+	if (!LastThen)
+	{
+		LastThen = FKismetCompilerUtilities::GenerateAssignmentNodes(CompilerContext, SourceGraph, CallBeginSpawnNode, SpawnNode, CallBeginResult, ClassToSpawn);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// branch on the created script, a rejected one skips the setters and 'finish'
+
+	UEdGraphPin* CallBeginThen = CallBeginSpawnNode->GetThenPin();
+	UEdGraphPin* FirstSetExec = CallBeginThen->LinkedTo.Num() > 0 ? CallBeginThen->LinkedTo[0] : NULL;
+	CallBeginThen->BreakAllPinLinks();
+
+	UK2Node_CallFunction* CallIsValidNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(SpawnNode, SourceGraph);
+	CallIsValidNode->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UKismetSystemLibrary, IsValid), UKismetSystemLibrary::StaticClass());
+	CallIsValidNode->AllocateDefaultPins();
+
+	static const FName IsValidObjectName(TEXT("Object"));
+	CallBeginResult->MakeLinkTo(CallIsValidNode->FindPinChecked(IsValidObjectName));
+
+	UK2Node_IfThenElse* BranchNode = CompilerContext.SpawnIntermediateNode<UK2Node_IfThenElse>(SpawnNode, SourceGraph);
+	BranchNode->AllocateDefaultPins();
+
+	CallIsValidNode->GetReturnValuePin()->MakeLinkTo(BranchNode->GetConditionPin());
+	CallBeginThen->MakeLinkTo(BranchNode->GetExecPin());
+
+	if (FirstSetExec)
+	{
+		BranchNode->GetThenPin()->MakeLinkTo(FirstSetExec);
+	}
+	else if (LastThen == CallBeginThen)
+	{
+		// No setters
+		LastThen = BranchNode->GetThenPin();
+	}
 
 	// Make exec connection between 'then' on last node and 'finish'
 	LastThen->MakeLinkTo(CallFinishExec);
 
+	UEdGraphPin* SpawnNodeFailed = SpawnNode->GetFailedPin();
+	if (SpawnNodeFailed->LinkedTo.Num() > 0)
+	{
+		CompilerContext.MovePinLinksToIntermediate(*SpawnNodeFailed, *BranchNode->GetElsePin());
+	}
+	else if (CallFinishThen && CallFinishThen->LinkedTo.Num() > 0)
+	{
+		// Continue from then as if the script had been added
+		BranchNode->GetElsePin()->MakeLinkTo(CallFinishThen->LinkedTo[0]);
+	}
+
 	// Break any links to the expanded node
 	SpawnNode->BreakAllNodeLinks();
 }
 
+//=================================================================================================
+// 
+//=================================================================================================
+UEdGraphPin* UK2Node_CreateScript::ExpandNativeSpawnParams(class FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph, class UK2Node_CallFunction* CallCreateNode, UEdGraphPin* ScriptPin, UClass* ForClass)
+{
+	if (!ForClass)
+	{
+		return NULL;
+	}
+
+	TArray<UEdGraphPin*> SpawnPins;
+	TArray<FString> PropertyNames;
+
+	for (UEdGraphPin* Pin : Pins)
+	{
+		if (!IsSpawnVarPin(Pin) || Pin->bOrphanedPin || Pin->ParentPin)
+		{
+			continue;
+		}
+
+		// Unchanged default values are already on the script
+		if (Pin->LinkedTo.Num() == 0 && Pin->DoesDefaultValueMatchAutogenerated())
+		{
+			continue;
+		}
+
+		// The assignment nodes report pins without a property
+		const FProperty* Property = FindFProperty<FProperty>(ForClass, Pin->PinName);
+		if (!Property)
+		{
+			return NULL;
+		}
+
+		// Setter functions are only called by the assignment nodes
+		if (Property->HasMetaData(FBlueprintMetadata::MD_PropertySetFunction))
+		{
+			return NULL;
+		}
+
+		SpawnPins.Add(Pin);
+		PropertyNames.Add(Pin->PinName.ToString());
+	}
+
+	if (SpawnPins.Num() == 0)
+	{
+		return NULL;
+	}
+
+	static const FName ScriptName(TEXT("Script"));
+
+	UK2Node_CallFunction* CallApplyNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+	CallApplyNode->FunctionReference.SetExternalMember(FK2Node_SimpleScriptHelper::ApplySpawnParams, UScriptQueueComponent::StaticClass());
+	CallApplyNode->AllocateDefaultPins();
+
+	ScriptPin->MakeLinkTo(CallApplyNode->FindPinChecked(ScriptName));
+
+	// The compile time class has every property that has a pin, a runtime class connected to the pin is a child of it
+	CallApplyNode->FindPinChecked(FK2Node_SimpleScriptHelper::ClassPinName)->DefaultObject = ForClass;
+	CallApplyNode->FindPinChecked(FK2Node_SimpleScriptHelper::PropertyNames)->DefaultValue = FString::Join(PropertyNames, TEXT(","));
+
+	// Variadic values are read in pin order, the names only have to be unique
+	for (int32 i = 0; i < SpawnPins.Num(); i++)
+	{
+		UEdGraphPin* SpawnPin = SpawnPins[i];
+		UEdGraphPin* ValuePin = CallApplyNode->CreatePin(EGPD_Input, SpawnPin->PinType, *FString::Printf(TEXT("Value_%d"), i));
+
+		ValuePin->DefaultValue = SpawnPin->DefaultValue;
+		ValuePin->DefaultObject = SpawnPin->DefaultObject;
+		ValuePin->DefaultTextValue = SpawnPin->DefaultTextValue;
+
+		CompilerContext.MovePinLinksToIntermediate(*SpawnPin, *ValuePin);
+	}
+
+	CallCreateNode->GetThenPin()->MakeLinkTo(CallApplyNode->GetExecPin());
+	return CallApplyNode->GetThenPin();
+}
+
 //=================================================================================================
 // 
 //=================================================================================================
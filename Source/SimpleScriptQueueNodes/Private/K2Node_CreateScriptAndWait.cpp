@@ -0,0 +1,123 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "K2Node_CreateScriptAndWait.h"
+#include "ScriptQueueComponent.h"
+#include "EdGraphSchema_K2.h"
+#include "K2Node_CallFunction.h"
+#include "KismetCompiler.h"
+
+//
+#define LOCTEXT_NAMESPACE "K2Node_CreateScriptAndWait"
+
+//=================================================================================================
+// 
+//=================================================================================================
+UK2Node_CreateScriptAndWait::UK2Node_CreateScriptAndWait(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	NodeTooltip = FText::FromString(TEXT("Add a new queued event and wait until it has finished.\nRunning the node again while it is still waiting adds the new event without waiting for it, its outputs only fire for the first one."));
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+FName UK2Node_CreateScriptAndWait::GetResultPinName(EScriptWaitResult Result)
+{
+	// Same names the call node expands the enum into
+	return FName(*StaticEnum<EScriptWaitResult>()->GetNameStringByValue((int64)Result));
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+void UK2Node_CreateScriptAndWait::AllocateExecOutputPins()
+{
+	UEdGraphPin* StartedPin = CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, GetResultPinName(EScriptWaitResult::Started));
+	StartedPin->PinToolTip = LOCTEXT("StartedPinDescription", "The script was activated").ToString();
+
+	UEdGraphPin* SucceededPin = CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, GetResultPinName(EScriptWaitResult::Succeeded));
+	SucceededPin->PinToolTip = LOCTEXT("SucceededPinDescription", "The script finished successfully").ToString();
+
+	// Same name as the failed pin of Create Script, so GetFailedPin finds it
+	UEdGraphPin* FailedPin = CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, GetResultPinName(EScriptWaitResult::Failed));
+	FailedPin->PinToolTip = LOCTEXT("FailedPinDescription", "The script was not created, failed or was cancelled").ToString();
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+bool UK2Node_CreateScriptAndWait::IsSpawnVarPin(UEdGraphPin* Pin) const
+{
+	return	Super::IsSpawnVarPin(Pin) &&
+			Pin->PinName != GetResultPinName(EScriptWaitResult::Started) &&
+			Pin->PinName != GetResultPinName(EScriptWaitResult::Succeeded);
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+FName UK2Node_CreateScriptAndWait::GetAddScriptFunctionName() const
+{
+	return GET_FUNCTION_NAME_CHECKED(UScriptQueueComponent, Node_AddScriptToQueueAndWait);
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+UEdGraphPin* UK2Node_CreateScriptAndWait::ExpandAddScriptOutputs(FKismetCompilerContext& CompilerContext, UK2Node_CallFunction* CallAddNode, UEdGraphPin* ScriptPin)
+{
+	const FName StartedName = GetResultPinName(EScriptWaitResult::Started);
+	const FName SucceededName = GetResultPinName(EScriptWaitResult::Succeeded);
+	const FName FailedName = GetResultPinName(EScriptWaitResult::Failed);
+
+	CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(StartedName), *CallAddNode->FindPinChecked(StartedName));
+	CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(SucceededName), *CallAddNode->FindPinChecked(SucceededName));
+
+	// Copied, Create Script moves the same links to the branch taken when the script was not created
+	CompilerContext.CopyPinLinksToIntermediate(*GetFailedPin(), *CallAddNode->FindPinChecked(FailedName));
+
+	// Latent functions have no return value, the script comes straight from the create call
+	UEdGraphPin* SpawnNodeResult = GetResultPin();
+	ScriptPin->PinType = SpawnNodeResult->PinType;
+	CompilerContext.MovePinLinksToIntermediate(*SpawnNodeResult, *ScriptPin);
+
+	// Failed covers both, nothing to fall back to
+	return NULL;
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+bool UK2Node_CreateScriptAndWait::IsCompatibleWithGraph(const UEdGraph* TargetGraph) const
+{
+	// Latent, only event graphs and macros can resume
+	const EGraphType GraphType = TargetGraph->GetSchema()->GetGraphType(TargetGraph);
+	return Super::IsCompatibleWithGraph(TargetGraph) && (GraphType == GT_Ubergraph || GraphType == GT_Macro);
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+FName UK2Node_CreateScriptAndWait::GetCornerIcon() const
+{
+	return TEXT("Graph.Latent.LatentIcon");
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+FText UK2Node_CreateScriptAndWait::GetBaseNodeTitle() const
+{
+	return FText::FromString(TEXT("Create Simple Script and Wait"));
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+FText UK2Node_CreateScriptAndWait::GetNodeTitleFormat() const
+{
+	return FText::FromString(TEXT("Add Script To Queue and Wait: {ClassName}"));
+}
+
+#undef LOCTEXT_NAMESPACE
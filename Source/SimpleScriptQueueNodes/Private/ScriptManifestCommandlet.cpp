@@ -0,0 +1,337 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "ScriptManifestCommandlet.h"
+#include "K2Node_CreateScript.h"
+#include "ScriptClassManifest.h"
+#include "SimpleScript.h"
+#include "Engine/Blueprint.h"
+#include "Engine/Level.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "HAL/FileManager.h"
+#include "Algo/Reverse.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "UObject/LinkerLoad.h"
+#include "ISourceControlModule.h"
+#include "SourceControlHelpers.h"
+
+//=================================================================================================
+// 
+//=================================================================================================
+UScriptManifestCommandlet::UScriptManifestCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+int32 UScriptManifestCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamsMap;
+	ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+	//Short or long package names, every map under /Game if not given
+	TArray<FString> MapFilter;
+	if (const FString* MapParam = ParamsMap.Find(TEXT("Map")))
+	{
+		MapParam->ParseIntoArray(MapFilter, TEXT(","));
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> Maps;
+	AssetRegistry.GetAssetsByClass(UWorld::StaticClass()->GetClassPathName(), Maps);
+
+	int32 Failed = 0;
+	for (const FAssetData& Map : Maps)
+	{
+		const FString MapPackageName = Map.PackageName.ToString();
+		if (MapFilter.Num() > 0)
+		{
+			if (!MapFilter.Contains(MapPackageName) && !MapFilter.Contains(FPackageName::GetShortName(MapPackageName)))
+				continue;
+		}
+		else if (!MapPackageName.StartsWith(TEXT("/Game/")))
+		{
+			continue;
+		}
+
+		if (!BuildManifest(MapPackageName))
+		{
+			Failed++;
+		}
+
+		//Maps can be big, don't keep them all loaded
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	return Failed > 0 ? 1 : 0;
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+bool UScriptManifestCommandlet::BuildManifest(const FString& MapPackageName)
+{
+	UPackage* MapPackage = LoadPackage(NULL, *MapPackageName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : NULL;
+	if (!World)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ScriptManifest: could not load map %s"), *MapPackageName);
+		return false;
+	}
+
+	const FString PackageName = UScriptClassManifest::GetManifestPackageName(MapPackageName);
+	const FString AssetName = FPackageName::GetShortName(PackageName);
+	const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+
+	UPackage* Package = FPackageName::DoesPackageExist(PackageName) ? LoadPackage(NULL, *PackageName, LOAD_None) : NULL;
+	UScriptClassManifest* Manifest = Package ? FindObject<UScriptClassManifest>(Package, *AssetName) : NULL;
+	const bool bFileExists = Package != NULL;
+	const bool bCreated = Manifest == NULL;
+
+	if (!Manifest)
+	{
+		if (!Package)
+		{
+			Package = CreatePackage(*PackageName);
+		}
+
+		Manifest = NewObject<UScriptClassManifest>(Package, *AssetName, RF_Public | RF_Standalone);
+	}
+
+	Manifest->Entries.Reset();
+
+	// Uses by the levels themselves
+	TMap<const UClass*, int32> RootUses;
+	CollectLevel(World->PersistentLevel, RootUses);
+
+	for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		if (!StreamingLevel)
+			continue;
+
+		UPackage* LevelPackage = LoadPackage(NULL, *StreamingLevel->GetWorldAssetPackageName(), LOAD_None);
+		UWorld* LevelWorld = LevelPackage ? UWorld::FindWorldInPackage(LevelPackage) : NULL;
+		if (LevelWorld)
+		{
+			CollectLevel(LevelWorld->PersistentLevel, RootUses);
+		}
+	}
+
+	// Scripts spawning other scripts, how many Create Script nodes of each class every reachable script class has
+	TMap<const UClass*, TMap<const UClass*, int32>> Spawns;
+	TArray<const UClass*> Pending;
+	RootUses.GenerateKeyArray(Pending);
+	while (Pending.Num() > 0)
+	{
+		const UClass* Class = Pending.Pop(EAllowShrinking::No);
+		if (Spawns.Contains(Class))
+			continue;
+
+		TMap<const UClass*, int32>& Spawned = Spawns.Add(Class);
+		CollectClass(Class, 1, Spawned);
+		for (const TPair<const UClass*, int32>& Pair : Spawned)
+		{
+			Pending.Add(Pair.Key);
+		}
+	}
+
+	// Push the uses down the spawn graph in topological order, each class only after every class spawning it.
+	// Edges back up the order close a cycle, a script that spawns its own class counts its direct uses only.
+	TArray<const UClass*> Order;
+	SortBySpawnOrder(RootUses, Spawns, Order);
+
+	TMap<const UClass*, int32> OrderIndex;
+	for (int32 i = 0; i < Order.Num(); i++)
+	{
+		OrderIndex.Add(Order[i], i);
+	}
+
+	TMap<const UClass*, int64> Uses;
+	for (const TPair<const UClass*, int32>& Pair : RootUses)
+	{
+		Uses.Add(Pair.Key, Pair.Value);
+	}
+
+	for (int32 i = 0; i < Order.Num(); i++)
+	{
+		const int64 ClassUses = Uses.FindRef(Order[i]);
+		for (const TPair<const UClass*, int32>& Pair : Spawns.FindChecked(Order[i]))
+		{
+			if (OrderIndex.FindChecked(Pair.Key) > i)
+			{
+				Uses.FindOrAdd(Pair.Key) += ClassUses * Pair.Value;
+			}
+		}
+	}
+
+	for (const TPair<const UClass*, int64>& Pair : Uses)
+	{
+		Manifest->AddUse(Pair.Key, (int32)FMath::Min<int64>(Pair.Value, MAX_int32));
+	}
+
+	const bool bSourceControl = ISourceControlModule::Get().IsEnabled();
+
+	if (Manifest->Entries.Num() == 0)
+	{
+		// Nothing to preload, don't leave an old manifest around
+		if (bFileExists)
+		{
+			// Loaded above, release the file before deleting it
+			Manifest->ClearFlags(RF_Public | RF_Standalone);
+			ResetLoaders(Package);
+
+			if (!(bSourceControl ? USourceControlHelpers::MarkFileForDelete(Filename) : IFileManager::Get().Delete(*Filename, false, true)))
+			{
+				UE_LOG(LogTemp, Error, TEXT("ScriptManifest: could not delete %s"), *Filename);
+				return false;
+			}
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("ScriptManifest: %s spawns no scripts"), *MapPackageName);
+		return true;
+	}
+
+	Manifest->SortEntries();
+
+	if (bCreated)
+	{
+		FAssetRegistryModule::AssetCreated(Manifest);
+	}
+
+	if (bSourceControl && bFileExists)
+	{
+		USourceControlHelpers::CheckOutFile(Filename);
+	}
+
+	Package->MarkPackageDirty();
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	SaveArgs.SaveFlags = SAVE_NoError;
+	if (!UPackage::SavePackage(Package, Manifest, *Filename, SaveArgs))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ScriptManifest: could not save %s"), *Filename);
+		return false;
+	}
+
+	if (bSourceControl && !bFileExists)
+	{
+		USourceControlHelpers::MarkFileForAdd(Filename);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("ScriptManifest: %s spawns %d script classes"), *MapPackageName, Manifest->Entries.Num());
+	return true;
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+void UScriptManifestCommandlet::SortBySpawnOrder(const TMap<const UClass*, int32>& RootUses, const TMap<const UClass*, TMap<const UClass*, int32>>& Spawns, TArray<const UClass*>& OutOrder)
+{
+	// Depth first post order from the level uses, reversed
+	TSet<const UClass*> Visited;
+	TArray<TPair<const UClass*, TArray<const UClass*>>> Stack;
+
+	for (const TPair<const UClass*, int32>& Root : RootUses)
+	{
+		if (Visited.Contains(Root.Key))
+			continue;
+
+		Visited.Add(Root.Key);
+		Stack.Emplace(Root.Key, TArray<const UClass*>());
+		Spawns.FindChecked(Root.Key).GenerateKeyArray(Stack.Last().Value);
+
+		while (Stack.Num() > 0)
+		{
+			TArray<const UClass*>& Children = Stack.Last().Value;
+			if (Children.Num() == 0)
+			{
+				OutOrder.Add(Stack.Last().Key);
+				Stack.Pop(EAllowShrinking::No);
+				continue;
+			}
+
+			const UClass* Child = Children.Pop(EAllowShrinking::No);
+			if (!Visited.Contains(Child))
+			{
+				Visited.Add(Child);
+				TArray<const UClass*> GrandChildren;
+				Spawns.FindChecked(Child).GenerateKeyArray(GrandChildren);
+				Stack.Emplace(Child, MoveTemp(GrandChildren));
+			}
+		}
+	}
+
+	Algo::Reverse(OutOrder);
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+void UScriptManifestCommandlet::CollectLevel(ULevel* Level, TMap<const UClass*, int32>& OutUses)
+{
+	if (!Level)
+		return;
+
+	if (UBlueprint* LevelBlueprint = Level->GetLevelScriptBlueprint(true))
+	{
+		CollectClass(LevelBlueprint->GeneratedClass, 1, OutUses);
+	}
+
+	//Every placed actor can have its scripts running at the same time
+	TMap<const UClass*, int32> ActorCounts;
+	for (const AActor* Actor : Level->Actors)
+	{
+		if (Actor && UBlueprint::GetBlueprintFromClass(Actor->GetClass()))
+		{
+			ActorCounts.FindOrAdd(Actor->GetClass())++;
+		}
+	}
+
+	for (const TPair<const UClass*, int32>& Pair : ActorCounts)
+	{
+		CollectClass(Pair.Key, Pair.Value, OutUses);
+	}
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+void UScriptManifestCommandlet::CollectClass(const UClass* Class, int32 Multiplier, TMap<const UClass*, int32>& OutUses)
+{
+	TArray<UBlueprint*> Blueprints;
+	if (!Class || !UBlueprint::GetBlueprintHierarchyFromClass(Class, Blueprints))
+		return;
+
+	for (UBlueprint* Blueprint : Blueprints)
+	{
+		TArray<UK2Node_CreateScript*> Nodes;
+		FBlueprintEditorUtils::GetAllNodesOfClass<UK2Node_CreateScript>(Blueprint, Nodes);
+
+		for (const UK2Node_CreateScript* Node : Nodes)
+		{
+			//NULL when the class comes from a connected pin, those can't be known here
+			UClass* ScriptClass = Node->GetClassToSpawn();
+			if (ScriptClass && ScriptClass->IsChildOf(USimpleScript::StaticClass()) && !ScriptClass->HasAnyClassFlags(CLASS_Abstract))
+			{
+				OutUses.FindOrAdd(ScriptClass) += Multiplier;
+			}
+		}
+	}
+}
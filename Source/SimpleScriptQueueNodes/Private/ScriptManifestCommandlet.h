@@ -0,0 +1,43 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ScriptManifestCommandlet.generated.h"
+
+//=================================================================================================
+// Writes a UScriptClassManifest next to every map, listing the script classes the Create Script
+// nodes of the map spawn. Scans the level Blueprint, the Blueprints of placed actors, streaming
+// levels, and the scripts those spawn in turn. Run before cooking:
+//   UnrealEditor-Cmd <Project> -run=ScriptManifest [-Map=MapA,MapB]
+//=================================================================================================
+UCLASS()
+class UScriptManifestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	//
+	UScriptManifestCommandlet();
+
+	//
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	//Build and save the manifest of one map. Returns false if the map could not be loaded or the manifest saved.
+	bool BuildManifest(const FString& MapPackageName);
+
+	//Level Blueprint and placed actors of a level
+	void CollectLevel(class ULevel* Level, TMap<const UClass*, int32>& OutUses);
+
+	//Create Script nodes of the class and its Blueprint parents, each counted Multiplier times
+	void CollectClass(const UClass* Class, int32 Multiplier, TMap<const UClass*, int32>& OutUses);
+
+	//Script classes ordered so that every class comes after the classes spawning it, except along cycles
+	static void SortBySpawnOrder(const TMap<const UClass*, int32>& RootUses, const TMap<const UClass*, TMap<const UClass*, int32>>& Spawns, TArray<const UClass*>& OutOrder);
+};
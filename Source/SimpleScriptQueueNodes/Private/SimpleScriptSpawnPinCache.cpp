@@ -0,0 +1,125 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "SimpleScriptSpawnPinCache.h"
+#include "EdGraphSchema_K2.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Editor.h"
+#include "UObject/UObjectGlobals.h"
+#include "Misc/CoreDelegates.h"
+
+TMap<TWeakObjectPtr<UClass>, TArray<FSimpleScriptSpawnPin>> FSimpleScriptSpawnPinCache::Cache;
+FDelegateHandle FSimpleScriptSpawnPinCache::PreCompileHandle;
+FDelegateHandle FSimpleScriptSpawnPinCache::CompiledHandle;
+FDelegateHandle FSimpleScriptSpawnPinCache::ReloadHandle;
+FDelegateHandle FSimpleScriptSpawnPinCache::PostEngineInitHandle;
+
+//=================================================================================================
+// 
+//=================================================================================================
+const TArray<FSimpleScriptSpawnPin>& FSimpleScriptSpawnPinCache::Get(UClass* Class)
+{
+	if (const TArray<FSimpleScriptSpawnPin>* Pins = Cache.Find(Class))
+	{
+		return *Pins;
+	}
+
+	TArray<FSimpleScriptSpawnPin>& Pins = Cache.Add(Class);
+	Build(Class, Pins);
+	return Pins;
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+void FSimpleScriptSpawnPinCache::Build(UClass* Class, TArray<FSimpleScriptSpawnPin>& OutPins)
+{
+	const UEdGraphSchema_K2* K2Schema = GetDefault<UEdGraphSchema_K2>();
+
+	const UObject* const ClassDefaultObject = Class->GetDefaultObject(false);
+
+	for (TFieldIterator<FProperty> PropertyIt(Class, EFieldIteratorFlags::IncludeSuper); PropertyIt; ++PropertyIt)
+	{
+		FProperty* Property = *PropertyIt;
+		const bool bIsDelegate = Property->IsA(FMulticastDelegateProperty::StaticClass());
+		const bool bIsExposedToSpawn = UEdGraphSchema_K2::IsPropertyExposedOnSpawn(Property);
+		const bool bIsSettableExternally = !Property->HasAnyPropertyFlags(CPF_DisableEditOnInstance);
+
+		if (!bIsExposedToSpawn ||
+			Property->HasAnyPropertyFlags(CPF_Parm) ||
+			!bIsSettableExternally ||
+			!Property->HasAllPropertyFlags(CPF_BlueprintVisible) ||
+			bIsDelegate ||
+			!FBlueprintEditorUtils::PropertyStillExists(Property))
+		{
+			continue;
+		}
+
+		FSimpleScriptSpawnPin& Pin = OutPins.AddDefaulted_GetRef();
+		Pin.PropertyName = Property->GetFName();
+		Pin.ToolTip = Property->GetToolTipText();
+		K2Schema->ConvertPropertyToPinType(Property, /*out*/ Pin.PinType);
+
+		if (ClassDefaultObject)
+		{
+			Pin.bHasDefaultValue = FBlueprintEditorUtils::PropertyValueToString(Property, reinterpret_cast<const uint8*>(ClassDefaultObject), Pin.DefaultValue);
+		}
+	}
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+void FSimpleScriptSpawnPinCache::Invalidate()
+{
+	Cache.Reset();
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+void FSimpleScriptSpawnPinCache::Startup()
+{
+	//The module loads before the editor exists
+	if (GEditor)
+	{
+		BindEditorEvents();
+	}
+	else
+	{
+		PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddStatic(&FSimpleScriptSpawnPinCache::BindEditorEvents);
+	}
+
+	ReloadHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason) { Invalidate(); });
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+void FSimpleScriptSpawnPinCache::BindEditorEvents()
+{
+	if (GEditor && !CompiledHandle.IsValid())
+	{
+		PreCompileHandle = GEditor->OnBlueprintPreCompile().AddLambda([](UBlueprint*) { Invalidate(); });
+		CompiledHandle = GEditor->OnBlueprintCompiled().AddStatic(&FSimpleScriptSpawnPinCache::Invalidate);
+	}
+}
+
+//=================================================================================================
+// 
+//=================================================================================================
+void FSimpleScriptSpawnPinCache::Shutdown()
+{
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+
+	if (GEditor)
+	{
+		GEditor->OnBlueprintPreCompile().Remove(PreCompileHandle);
+		GEditor->OnBlueprintCompiled().Remove(CompiledHandle);
+	}
+
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadHandle);
+
+	Invalidate();
+}
@@ -0,0 +1,66 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EdGraph/EdGraphPin.h"
+
+//=================================================================================================
+// 
+//=================================================================================================
+struct FSimpleScriptSpawnPin
+{
+	//
+	FName PropertyName;
+
+	//
+	FEdGraphPinType PinType;
+
+	//Default value of the class default object as a pin default string
+	FString DefaultValue;
+
+	//If the pin type has an editable default value
+	bool bHasDefaultValue = false;
+
+	//
+	FText ToolTip;
+};
+
+//=================================================================================================
+// Exposed on spawn properties of script classes and their default values, shared by every
+// Create Script node that targets the class. Thrown away whenever a Blueprint is compiled or
+// native code is reloaded, since the defaults of child classes depend on their parents.
+//=================================================================================================
+class FSimpleScriptSpawnPinCache
+{
+public:
+
+	//Spawn pins of the class, built the first time the class is asked for
+	static const TArray<FSimpleScriptSpawnPin>& Get(UClass* Class);
+
+	//
+	static void Invalidate();
+
+	//Hook the invalidation to Blueprint compiles and reloads
+	static void Startup();
+	static void Shutdown();
+
+private:
+
+	//
+	static void Build(UClass* Class, TArray<FSimpleScriptSpawnPin>& OutPins);
+
+	//
+	static void BindEditorEvents();
+
+	//
+	static TMap<TWeakObjectPtr<UClass>, TArray<FSimpleScriptSpawnPin>> Cache;
+
+	//
+	static FDelegateHandle PreCompileHandle;
+	static FDelegateHandle CompiledHandle;
+	static FDelegateHandle ReloadHandle;
+	static FDelegateHandle PostEngineInitHandle;
+};
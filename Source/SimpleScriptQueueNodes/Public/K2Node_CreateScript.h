@@ -57,12 +57,18 @@ class SIMPLESCRIPTQUEUENODES_API UK2Node_CreateScript : public UK2Node
 
 	/** Get the then output pin */
 	UEdGraphPin* GetThenPin() const;
+	/** Get the output pin taken when the script was not created */
+	UEdGraphPin* GetFailedPin() const;
 	/** Get the blueprint input pin */
 	UEdGraphPin* GetClassPin(const TArray<UEdGraphPin*>* InPinsToSearch = NULL) const;
 
 	/** Get the class that we are going to spawn, if it's defined as default value */
 	UClass* GetClassToSpawn(const TArray<UEdGraphPin*>* InPinsToSearch = NULL) const;
 
+	/** Set all spawn values with one native call instead of a setter node per value. Off by default so existing nodes keep their expansion. */
+	UPROPERTY(EditAnywhere, Category = "Script")
+	bool bNativeSpawnParams = false;
+
 protected:
 	/** Gets the default node title when no class is selected */
 	virtual FText GetBaseNodeTitle() const;
@@ -92,6 +98,24 @@ protected:
 	/** Refresh pins when class was changed */
 	void OnClassPinChanged();
 
+	/** Create the exec output pins, then and failed by default */
+	virtual void AllocateExecOutputPins();
+
+	/** Function of UScriptQueueComponent that adds the created script to its queue */
+	virtual FName GetAddScriptFunctionName() const;
+
+	/**
+	* Move the exec and result outputs of this node to the intermediate nodes
+	*
+	* @param   CallAddNode	The call adding the script to its queue
+	* @param   ScriptPin	The created script
+	* @return  Where a script that was not created continues when failed is not connected, or NULL
+	*/
+	virtual UEdGraphPin* ExpandAddScriptOutputs(class FKismetCompilerContext& CompilerContext, class UK2Node_CallFunction* CallAddNode, UEdGraphPin* ScriptPin);
+
+	/** Set the spawn pins with one Node_ApplySpawnParams call. Returns NULL when there is nothing to set or a property needs its setter function. */
+	UEdGraphPin* ExpandNativeSpawnParams(class FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph, class UK2Node_CallFunction* CallCreateNode, UEdGraphPin* ScriptPin, UClass* ForClass);
+
 	/** Tooltip text for this node. */
 	FText NodeTooltip;
 
@@ -0,0 +1,40 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "K2Node_CreateScript.h"
+#include "K2Node_CreateScriptAndWait.generated.h"
+
+//=================================================================================================
+// Create Script that waits for the script. Resumes through Started and then Succeeded or Failed,
+// signalled by the script itself instead of bound OnStarted and OnFinished events.
+//=================================================================================================
+UCLASS()
+class SIMPLESCRIPTQUEUENODES_API UK2Node_CreateScriptAndWait : public UK2Node_CreateScript
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UEdGraphNode Interface.
+	virtual bool IsCompatibleWithGraph(const UEdGraph* TargetGraph) const override;
+	virtual FName GetCornerIcon() const override;
+	//~ End UEdGraphNode Interface.
+
+	//~ Begin UK2Node_CreateScript Interface
+	virtual bool IsSpawnVarPin(UEdGraphPin* Pin) const override;
+	//~ End UK2Node_CreateScript Interface
+
+protected:
+	//~ Begin UK2Node_CreateScript Interface
+	virtual FText GetBaseNodeTitle() const override;
+	virtual FText GetNodeTitleFormat() const override;
+	virtual void AllocateExecOutputPins() override;
+	virtual FName GetAddScriptFunctionName() const override;
+	virtual UEdGraphPin* ExpandAddScriptOutputs(class FKismetCompilerContext& CompilerContext, class UK2Node_CallFunction* CallAddNode, UEdGraphPin* ScriptPin) override;
+	//~ End UK2Node_CreateScript Interface
+
+	/** Name of the exec output pin of a wait result */
+	static FName GetResultPinName(EScriptWaitResult Result);
+};
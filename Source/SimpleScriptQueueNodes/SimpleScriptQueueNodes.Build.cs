@@ -14,7 +14,7 @@ public class SimpleScriptQueueNodes : ModuleRules
 	
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "Slate", "SlateCore", "PropertyEditor" });
 
-       PublicDependencyModuleNames.AddRange(new string[] { "UnrealEd", "EditorStyle", "GraphEditor", "KismetCompiler", "BlueprintGraph", "SimpleScriptQueue" });
+       PublicDependencyModuleNames.AddRange(new string[] { "UnrealEd", "EditorStyle", "GraphEditor", "KismetCompiler", "BlueprintGraph", "AssetRegistry", "SourceControl", "SimpleScriptQueue" });
 		
 		// Uncomment if you are using online features
 		// PrivateDependencyModuleNames.Add("OnlineSubsystem");
@@ -2,6 +2,7 @@
 
 #include "SimpleScriptQueueNodes.h"
 #include "Modules/ModuleManager.h"
+#include "SimpleScriptSpawnPinCache.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FSimpleScriptQueueNodes_Module, SimpleScriptQueueNodes, "SimpleScriptQueueNodes" );
 
@@ -12,6 +13,7 @@ void FSimpleScriptQueueNodes_Module::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 
+	FSimpleScriptSpawnPinCache::Startup();
 }
 
 //=========================================================================================================================
@@ -22,5 +24,6 @@ void FSimpleScriptQueueNodes_Module::ShutdownModule()
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
 
+	FSimpleScriptSpawnPinCache::Shutdown();
 
 }